@@ -0,0 +1,460 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains benchmarking utilities shared by all benchmarks. Is not safe to
+/// include in multiple files.
+///
+/// Benchmarks register cases with benchmark_runner::run, which times warmup
+/// and measured repetitions of a case and computes statistics over the
+/// measured repetitions. The following command line options are understood:
+///
+/// --benchmark_filter=<regex>       only run cases whose name matches regex
+/// --benchmark_sizes=<n>,<n>,...    override the problem sizes of a benchmark
+/// --benchmark_warmup=<n>           number of untimed warmup repetitions
+/// --benchmark_repetitions=<n>      number of timed repetitions
+/// --benchmark_format=<csv|json>    output format (csv by default)
+/// --benchmark_out=<file>           write results to file instead of stdout
+/// --benchmark_list                 list the cases instead of running them
+/// --benchmark_baseline=<file>      compare against the baseline in file, or
+///                                  store a baseline in file if it does not
+///                                  exist
+/// --benchmark_update_baseline      overwrite the baseline instead of
+///                                  comparing against it
+/// --benchmark_threshold=<x>        relative slowdown of the median that is
+///                                  considered a regression (0.05 by default)
+///
+/// A case regresses when its median time is slower than in the baseline by
+/// more than the threshold, and a Welch t-test on the mean times finds the
+/// slowdown significant. Baselines are only compared when they were recorded
+/// with the same default execution space and number of HPX worker threads.
+
+#pragma once
+
+#include <hpx/chrono.hpp>
+#include <hpx/config/version.hpp>
+#include <hpx/runtime.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+struct benchmark_statistics {
+  double min = 0;
+  double max = 0;
+  double mean = 0;
+  double median = 0;
+  double p99 = 0;
+  double stddev = 0;
+};
+
+/// Returns the Welch t statistic for the difference of the means of the
+/// current and baseline samples, positive when the current samples are slower.
+inline double welch_t(benchmark_statistics const &current,
+                      std::size_t current_n,
+                      benchmark_statistics const &baseline,
+                      std::size_t baseline_n) {
+  double const variance = current.stddev * current.stddev / current_n +
+                          baseline.stddev * baseline.stddev / baseline_n;
+  double const difference = current.mean - baseline.mean;
+  if (variance == 0) {
+    return difference > 0 ? HUGE_VAL : difference < 0 ? -HUGE_VAL : 0;
+  }
+  return difference / std::sqrt(variance);
+}
+
+inline benchmark_statistics
+compute_statistics(std::vector<double> samples) {
+  benchmark_statistics s;
+  if (samples.empty()) {
+    return s;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  auto const n = samples.size();
+  s.min = samples.front();
+  s.max = samples.back();
+  s.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+  s.median = n % 2 == 1 ? samples[n / 2]
+                        : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  // Nearest-rank percentile
+  auto const rank = static_cast<std::size_t>(std::ceil(0.99 * n));
+  s.p99 = samples[std::max<std::size_t>(rank, 1) - 1];
+  double sq = 0;
+  for (double x : samples) {
+    sq += (x - s.mean) * (x - s.mean);
+  }
+  s.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0;
+  return s;
+}
+
+/// Parameters of a benchmark case, in the order they appear in its name.
+using benchmark_parameters = std::vector<std::pair<std::string, std::string>>;
+
+struct benchmark_result {
+  std::string name;
+  benchmark_parameters parameters;
+  std::size_t repetitions = 0;
+  benchmark_statistics time;
+  /// Additional metrics derived from the timings, e.g. bandwidth.
+  std::map<std::string, double> metrics;
+};
+
+class benchmark_runner {
+public:
+  benchmark_runner(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+      std::string const arg = argv[i];
+      std::string value;
+      if (match(arg, "--benchmark_filter=", value)) {
+        filter = std::regex(value);
+      } else if (match(arg, "--benchmark_sizes=", value)) {
+        std::istringstream is(value);
+        for (std::string size; std::getline(is, size, ',');) {
+          sizes_.push_back(std::stoull(size));
+        }
+      } else if (match(arg, "--benchmark_warmup=", value)) {
+        warmup = std::stoull(value);
+      } else if (match(arg, "--benchmark_repetitions=", value)) {
+        repetitions = std::max<std::size_t>(std::stoull(value), 1);
+      } else if (match(arg, "--benchmark_format=", value)) {
+        json = value == "json";
+      } else if (match(arg, "--benchmark_out=", value)) {
+        out.open(value);
+      } else if (arg == "--benchmark_list") {
+        list = true;
+      } else if (match(arg, "--benchmark_baseline=", value)) {
+        baseline_file = value;
+      } else if (arg == "--benchmark_update_baseline") {
+        update_baseline = true;
+      } else if (match(arg, "--benchmark_threshold=", value)) {
+        threshold = std::stod(value);
+      }
+    }
+
+    if (!json && !list) {
+      stream() << "name,repetitions,min,median,mean,p99,stddev,max\n";
+    }
+  }
+
+  ~benchmark_runner() { report(); }
+
+  benchmark_runner(benchmark_runner const &) = delete;
+  benchmark_runner &operator=(benchmark_runner const &) = delete;
+
+  /// Returns the problem sizes given on the command line, or defaults if
+  /// none were given.
+  std::vector<std::size_t> sizes(std::vector<std::size_t> defaults) const {
+    return sizes_.empty() ? defaults : sizes_;
+  }
+
+  /// Times f for the case made up of name and parameters, unless it is
+  /// filtered out. setup is called untimed before every repetition. Returns
+  /// the result of the case, or nullptr if it was not run.
+  template <typename Setup, typename F>
+  benchmark_result *run(std::string const &name,
+                        benchmark_parameters const &parameters, Setup &&setup,
+                        F &&f) {
+    std::string full_name = name;
+    for (auto const &p : parameters) {
+      full_name += "/" + p.first + ":" + p.second;
+    }
+    if (!std::regex_search(full_name, filter)) {
+      return nullptr;
+    }
+    if (list) {
+      stream() << full_name << '\n';
+      return nullptr;
+    }
+
+    for (std::size_t r = 0; r < warmup; ++r) {
+      setup();
+      f();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (std::size_t r = 0; r < repetitions; ++r) {
+      setup();
+      hpx::chrono::high_resolution_timer timer;
+      f();
+      samples.push_back(timer.elapsed());
+    }
+
+    results.push_back(benchmark_result{std::move(full_name), parameters,
+                                       repetitions,
+                                       compute_statistics(samples),
+                                       {}});
+    if (!json) {
+      auto const &r = results.back();
+      stream() << r.name << ',' << r.repetitions << ',' << r.time.min << ','
+               << r.time.median << ',' << r.time.mean << ',' << r.time.p99
+               << ',' << r.time.stddev << ',' << r.time.max << '\n';
+    }
+    return &results.back();
+  }
+
+  template <typename F>
+  benchmark_result *run(std::string const &name,
+                        benchmark_parameters const &parameters, F &&f) {
+    return run(
+        name, parameters, [] {}, std::forward<F>(f));
+  }
+
+  std::vector<benchmark_result> const &get_results() const { return results; }
+
+  /// Writes the results in JSON format, if requested, and compares them
+  /// against or stores them as the baseline. Returns non-zero if a regression
+  /// was found. Called automatically on destruction.
+  int report() {
+    if (list || reported) {
+      return 0;
+    }
+    reported = true;
+
+    if (json) {
+      report_json();
+    }
+    if (baseline_file.empty()) {
+      return 0;
+    }
+    if (!update_baseline && std::ifstream(baseline_file).good()) {
+      return compare_baseline();
+    }
+    save_baseline();
+    return 0;
+  }
+
+private:
+  struct baseline_entry {
+    std::size_t repetitions = 0;
+    benchmark_statistics time;
+    std::map<std::string, double> metrics;
+  };
+
+  // The configuration that timings depend on. Baselines recorded with a
+  // different configuration are not compared against.
+  static std::string configuration() {
+    return std::string("default_execution_space=") +
+           Kokkos::DefaultExecutionSpace::name() +
+           " hpx_threads=" + std::to_string(hpx::get_num_worker_threads());
+  }
+
+  static std::string versions() {
+    return "hpx_version=" + std::to_string(HPX_VERSION_MAJOR) + '.' +
+           std::to_string(HPX_VERSION_MINOR) + '.' +
+           std::to_string(HPX_VERSION_SUBMINOR) +
+           " kokkos_version=" + std::to_string(KOKKOS_VERSION);
+  }
+
+  void save_baseline() const {
+    std::ofstream os(baseline_file);
+    os << std::setprecision(9);
+    os << "configuration " << configuration() << '\n';
+    os << "versions " << versions() << '\n';
+    for (auto const &r : results) {
+      os << "case " << r.name << ' ' << r.repetitions << ' ' << r.time.median
+         << ' ' << r.time.mean << ' ' << r.time.stddev;
+      for (auto const &m : r.metrics) {
+        os << ' ' << m.first << '=' << m.second;
+      }
+      os << '\n';
+    }
+    std::cerr << "benchmark baseline written to " << baseline_file << '\n';
+  }
+
+  int compare_baseline() const {
+    std::ifstream is(baseline_file);
+    std::string baseline_configuration;
+    std::string baseline_versions;
+    std::map<std::string, baseline_entry> baseline;
+    for (std::string line; std::getline(is, line);) {
+      std::istringstream ls(line);
+      std::string kind;
+      ls >> kind >> std::ws;
+      if (kind == "configuration") {
+        std::getline(ls, baseline_configuration);
+      } else if (kind == "versions") {
+        std::getline(ls, baseline_versions);
+      } else if (kind == "case") {
+        std::string name;
+        baseline_entry e;
+        ls >> name >> e.repetitions >> e.time.median >> e.time.mean >>
+            e.time.stddev;
+        for (std::string metric; ls >> metric;) {
+          auto const eq = metric.find('=');
+          if (eq != std::string::npos) {
+            e.metrics[metric.substr(0, eq)] =
+                std::stod(metric.substr(eq + 1));
+          }
+        }
+        baseline[name] = e;
+      }
+    }
+
+    if (baseline_configuration != configuration()) {
+      std::cerr << "benchmark baseline " << baseline_file
+                << " was recorded with a different configuration ("
+                << baseline_configuration << " instead of " << configuration()
+                << "), not comparing\n";
+      return 0;
+    }
+
+    // Significance level of roughly 1% for a one-sided test
+    double const critical_t = 2.58;
+    std::ostringstream diff;
+    diff << std::setprecision(4);
+    std::size_t compared = 0;
+    std::size_t regressions = 0;
+    for (auto const &r : results) {
+      auto const it = baseline.find(r.name);
+      if (it == baseline.end()) {
+        continue;
+      }
+      ++compared;
+      auto const &b = it->second;
+      double const change = r.time.median / b.time.median - 1;
+      double const t = welch_t(r.time, r.repetitions, b.time, b.repetitions);
+      if (change <= threshold || t <= critical_t) {
+        continue;
+      }
+      ++regressions;
+      diff << "  " << r.name << ": median " << b.time.median << " s -> "
+           << r.time.median << " s (+" << change * 100 << "%, t = " << t
+           << ")";
+      for (auto const &m : r.metrics) {
+        auto const bm = b.metrics.find(m.first);
+        if (bm != b.metrics.end()) {
+          diff << ", " << m.first << ' ' << bm->second << " -> " << m.second;
+        }
+      }
+      diff << '\n';
+    }
+
+    std::cerr << "compared " << compared << " benchmark cases against "
+              << baseline_file << ", " << regressions << " regressed\n";
+    if (regressions > 0) {
+      std::cerr << "baseline: " << baseline_versions << '\n'
+                << "current:  " << versions() << '\n'
+                << diff.str();
+      return 1;
+    }
+    return 0;
+  }
+
+  void report_json() {
+    auto &os = stream();
+    os << std::setprecision(9);
+    os << "{\n  \"context\": {\n"
+       << "    \"hpx_version\": \"" << HPX_VERSION_MAJOR << '.'
+       << HPX_VERSION_MINOR << '.' << HPX_VERSION_SUBMINOR << "\",\n"
+       << "    \"kokkos_version\": " << KOKKOS_VERSION << ",\n"
+       << "    \"default_execution_space\": \""
+       << Kokkos::DefaultExecutionSpace::name() << "\",\n"
+       << "    \"warmup\": " << warmup << ",\n"
+       << "    \"repetitions\": " << repetitions << "\n  },\n"
+       << "  \"benchmarks\": [";
+    char const *separator = "\n";
+    for (auto const &r : results) {
+      os << separator << "    {\"name\": \"" << r.name
+         << "\", \"repetitions\": " << r.repetitions << ", \"parameters\": {";
+      char const *psep = "";
+      for (auto const &p : r.parameters) {
+        os << psep << '"' << p.first << "\": \"" << p.second << '"';
+        psep = ", ";
+      }
+      os << "}, \"unit\": \"s\", \"min\": " << r.time.min
+         << ", \"median\": " << r.time.median << ", \"mean\": " << r.time.mean
+         << ", \"p99\": " << r.time.p99 << ", \"stddev\": " << r.time.stddev
+         << ", \"max\": " << r.time.max << ", \"metrics\": {";
+      psep = "";
+      for (auto const &m : r.metrics) {
+        os << psep << '"' << m.first << "\": " << m.second;
+        psep = ", ";
+      }
+      os << "}}";
+      separator = ",\n";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  static bool match(std::string const &arg, char const *option,
+                    std::string &value) {
+    std::string const o(option);
+    if (arg.compare(0, o.size(), o) != 0) {
+      return false;
+    }
+    value = arg.substr(o.size());
+    return true;
+  }
+
+  std::ostream &stream() { return out.is_open() ? out : std::cout; }
+
+  std::regex filter{".*"};
+  std::vector<std::size_t> sizes_;
+  std::size_t warmup = 1;
+  std::size_t repetitions = 10;
+  bool json = false;
+  bool list = false;
+  bool reported = false;
+  std::string baseline_file;
+  bool update_baseline = false;
+  double threshold = 0.05;
+  std::ofstream out;
+  std::vector<benchmark_result> results;
+};
+
+template <typename ExecutionSpace> constexpr bool is_default_space() {
+  return std::is_same<ExecutionSpace, Kokkos::DefaultExecutionSpace>::value ||
+         std::is_same<ExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value;
+}
+
+/// Calls f with an instance of every enabled Kokkos execution space, so that
+/// benchmarks cover the device as well as the HPX, OpenMP and Serial
+/// backends.
+template <typename F> void for_each_execution_space(F &&f) {
+  f(Kokkos::DefaultExecutionSpace{});
+  if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                    Kokkos::DefaultHostExecutionSpace>::value) {
+    f(Kokkos::DefaultHostExecutionSpace{});
+  }
+#if defined(KOKKOS_ENABLE_HPX)
+  if constexpr (!is_default_space<Kokkos::Experimental::HPX>()) {
+    f(Kokkos::Experimental::HPX{});
+  }
+#endif
+#if defined(KOKKOS_ENABLE_OPENMP)
+  if constexpr (!is_default_space<Kokkos::OpenMP>()) {
+    f(Kokkos::OpenMP{});
+  }
+#endif
+#if defined(KOKKOS_ENABLE_SERIAL)
+  if constexpr (!is_default_space<Kokkos::Serial>()) {
+    f(Kokkos::Serial{});
+  }
+#endif
+}
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,123 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Compares ways of orchestrating a pipeline of dependent kernels, where each
+/// step launches a kernel once the kernel of the previous step has completed.
+/// The steps are chained with a blocking get, with .then continuations, and,
+/// when the compiler and HPX support coroutines, in a coroutine awaiting the
+/// future of each step. The coroutine doubles as an example of a pipeline
+/// written with hpx::kokkos::awaitable.
+
+#include "benchmark.hpp"
+
+#include <Kokkos_Core.hpp>
+#include <hpx/config.hpp>
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <string>
+#include <type_traits>
+
+enum class pipeline_type { get, then, coroutine };
+
+#if defined(HPX_KOKKOS_HAVE_COROUTINES) && defined(HPX_HAVE_CXX20_COROUTINES)
+// Each step continues inline if its kernel has already completed, and is
+// otherwise resumed directly from the completion of the kernel's future.
+template <typename ExecutionSpace, typename Kernel>
+hpx::future<void> coroutine_pipeline(ExecutionSpace inst, Kernel kernel,
+                                     int const n, int const steps) {
+  for (int s = 0; s < steps; ++s) {
+    co_await hpx::kokkos::awaitable(hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<ExecutionSpace>(inst, 0, n), kernel));
+  }
+}
+#endif
+
+template <typename ExecutionSpace>
+void test_pipeline(ExecutionSpace const &inst,
+                   Kokkos::View<int *, ExecutionSpace> a, int const n,
+                   int const steps, pipeline_type t) {
+  auto const kernel = KOKKOS_LAMBDA(int i) { a(i) += 1; };
+  auto const launch = [=] {
+    return hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<ExecutionSpace>(inst, 0, n), kernel);
+  };
+
+  switch (t) {
+  case pipeline_type::get:
+    for (int s = 0; s < steps; ++s) {
+      launch().get();
+    }
+    break;
+  case pipeline_type::then: {
+    hpx::shared_future<void> f = hpx::make_ready_future();
+    for (int s = 0; s < steps; ++s) {
+      f = hpx::shared_future<void>(
+          f.then(hpx::launch::sync, [=](auto &&) { return launch(); }));
+    }
+    f.get();
+    break;
+  }
+  case pipeline_type::coroutine:
+#if defined(HPX_KOKKOS_HAVE_COROUTINES) && defined(HPX_HAVE_CXX20_COROUTINES)
+    coroutine_pipeline(inst, kernel, n, steps).get();
+#endif
+    break;
+  }
+}
+
+template <typename ExecutionSpace>
+void test_pipeline(hpx::kokkos::detail::benchmark_runner &b,
+                   ExecutionSpace const &inst, int const n, int const steps) {
+  Kokkos::View<int *, ExecutionSpace> a("a", n);
+
+  hpx::kokkos::detail::benchmark_parameters const params{
+      {"space", inst.name()},
+      {"size", std::to_string(n)},
+      {"steps", std::to_string(steps)}};
+
+  b.run("coroutine/get", params,
+        [&] { test_pipeline(inst, a, n, steps, pipeline_type::get); });
+  b.run("coroutine/then", params,
+        [&] { test_pipeline(inst, a, n, steps, pipeline_type::then); });
+#if defined(HPX_KOKKOS_HAVE_COROUTINES) && defined(HPX_HAVE_CXX20_COROUTINES)
+  auto *r = b.run("coroutine/co_await", params, [&] {
+    test_pipeline(inst, a, n, steps, pipeline_type::coroutine);
+  });
+  if (r != nullptr) {
+    r->metrics["steps_per_second"] = steps / r->time.median;
+  }
+#endif
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  int result = 0;
+  {
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
+
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &space) {
+      using execution_space = typename std::decay<decltype(space)>::type;
+      hpx::kokkos::kokkos_instance_helper<execution_space> h;
+      for (auto const n : b.sizes({1, 1000, 100000})) {
+        test_pipeline(b, h.get_execution_space(), int(n), 100);
+      }
+    });
+
+    result = b.report();
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,140 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Compares ways of launching a dense DAG of small kernels. The DAG is a
+/// lattice of a given width and depth, where every task depends on its
+/// neighbours in the previous level. Each task launches a kernel on a single
+/// element. The tasks are launched with hpx::dataflow, with the dependency
+/// overloads of parallel_for_async, and with hpx::kokkos::dataflow.
+///
+/// The columns of the lattice are launched either all on one instance or on
+/// different instances. With a single in-order instance every dependency is
+/// already satisfied by the order of the instance. With different instances
+/// the dependencies on neighbouring columns come from other instances, which
+/// measures waiting for dependencies through completion callbacks.
+
+#include "benchmark.hpp"
+
+#include <Kokkos_Core.hpp>
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+enum class dataflow_type { hpx, launch_after, kokkos };
+
+template <typename ExecutionSpace>
+void test_dag(std::vector<ExecutionSpace> const &instances,
+              Kokkos::View<int *, ExecutionSpace> a, int const width,
+              int const depth, dataflow_type t) {
+  auto const kernel = KOKKOS_LAMBDA(int i) { a(i) += 1; };
+
+  std::vector<hpx::shared_future<void>> previous(width,
+                                                 hpx::make_ready_future());
+  std::vector<hpx::shared_future<void>> current(width);
+
+  for (int l = 0; l < depth; ++l) {
+    for (int i = 0; i < width; ++i) {
+      auto const &left = previous[i == 0 ? width - 1 : i - 1];
+      auto const &center = previous[i];
+      auto const &right = previous[i == width - 1 ? 0 : i + 1];
+      auto const &inst = instances[i % instances.size()];
+      auto const launch = [=](ExecutionSpace const &space) {
+        return hpx::kokkos::parallel_for_async(
+            Kokkos::RangePolicy<ExecutionSpace>(space, i, i + 1), kernel);
+      };
+
+      switch (t) {
+      case dataflow_type::hpx:
+        current[i] = hpx::shared_future<void>(hpx::dataflow(
+            [=](auto &&...) { return launch(inst); }, left, center, right));
+        break;
+      case dataflow_type::launch_after:
+        current[i] = hpx::kokkos::parallel_for_async(
+            std::vector<hpx::shared_future<void>>{left, center, right},
+            Kokkos::RangePolicy<ExecutionSpace>(inst, i, i + 1), kernel);
+        break;
+      case dataflow_type::kokkos:
+        current[i] = hpx::kokkos::dataflow(inst, launch, left, center, right);
+        break;
+      }
+    }
+    std::swap(previous, current);
+  }
+
+  hpx::wait_all(previous);
+}
+
+template <typename ExecutionSpace>
+void test_dag(hpx::kokkos::detail::benchmark_runner &b,
+              std::vector<ExecutionSpace> const &instances, int const width,
+              int const depth) {
+  Kokkos::View<int *, ExecutionSpace> a("a", width);
+
+  hpx::kokkos::detail::benchmark_parameters const params{
+      {"space", instances.front().name()},
+      {"instances", std::to_string(instances.size())},
+      {"width", std::to_string(width)},
+      {"depth", std::to_string(depth)}};
+
+  b.run("dataflow/hpx", params,
+        [&] { test_dag(instances, a, width, depth, dataflow_type::hpx); });
+  b.run("dataflow/launch_after", params, [&] {
+    test_dag(instances, a, width, depth, dataflow_type::launch_after);
+  });
+  auto *r = b.run("dataflow/kokkos", params, [&] {
+    test_dag(instances, a, width, depth, dataflow_type::kokkos);
+  });
+  if (r != nullptr) {
+    r->metrics["tasks_per_second"] = width * depth / r->time.median;
+  }
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  int result = 0;
+  {
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
+
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &space) {
+      using execution_space = typename std::decay<decltype(space)>::type;
+      hpx::kokkos::kokkos_instance_helper<execution_space> h;
+      for (auto const width : b.sizes({1, 4, 16, 64})) {
+        // All columns on one instance
+        test_dag(b, std::vector<execution_space>{h.get_execution_space()},
+                 int(width), 64);
+
+        // Each column on its own instance
+        if (width > 1) {
+          std::vector<execution_space> instances;
+          for (std::size_t i = 0; i < width; ++i) {
+            instances.push_back(
+                hpx::kokkos::detail::make_independent_execution_space_instance<
+                    execution_space>());
+          }
+          test_dag(b, instances, int(width), 64);
+        }
+      }
+    });
+
+    result = b.report();
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
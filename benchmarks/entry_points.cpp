@@ -0,0 +1,173 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Benchmarks the asynchronous entry points of the library: Kokkos algorithms,
+/// deep copies, executors, HPX algorithms, and graphs, with and without
+/// dependencies.
+
+#include "benchmark.hpp"
+
+#include <Kokkos_Core.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+#include <hpx/numeric.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+template <typename ExecutionSpace>
+void test_entry_points(hpx::kokkos::detail::benchmark_runner &b,
+                       ExecutionSpace const &inst, std::size_t const n) {
+  using policy_type = Kokkos::RangePolicy<ExecutionSpace>;
+
+  hpx::kokkos::detail::benchmark_parameters const params{
+      {"space", inst.name()}, {"size", std::to_string(n)}};
+  auto const name = [](char const *entry_point) {
+    return std::string("entry_points/") + entry_point;
+  };
+
+  Kokkos::View<int *, ExecutionSpace> data("data", n);
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  hpx::kokkos::executor<ExecutionSpace> exec(inst);
+
+  b.run(name("parallel_for_async"), params, [&] {
+    hpx::kokkos::parallel_for_async(policy_type(inst, 0, n),
+                                    KOKKOS_LAMBDA(int i) { data(i) = i; })
+        .get();
+  });
+
+  b.run(name("parallel_for_async_dependency"), params, [&] {
+    hpx::kokkos::parallel_for_async(hpx::make_ready_future(),
+                                    policy_type(inst, 0, n),
+                                    KOKKOS_LAMBDA(int i) { data(i) = i; })
+        .get();
+  });
+
+  b.run(name("parallel_for_async_instance_dependency"), params, [&] {
+    hpx::kokkos::parallel_for_async(hpx::kokkos::after(inst),
+                                    policy_type(inst, 0, n),
+                                    KOKKOS_LAMBDA(int i) { data(i) = i; })
+        .get();
+  });
+
+  b.run(name("parallel_reduce_async"), params, [&] {
+    int sum = 0;
+    hpx::kokkos::parallel_reduce_async(
+        policy_type(inst, 0, n),
+        KOKKOS_LAMBDA(int i, int &acc) { acc += data(i); },
+        Kokkos::Sum<int>(sum))
+        .get();
+  });
+
+  b.run(name("parallel_reduce_async_dependency"), params, [&] {
+    int sum = 0;
+    hpx::kokkos::parallel_reduce_async(
+        hpx::make_ready_future(), policy_type(inst, 0, n),
+        KOKKOS_LAMBDA(int i, int &acc) { acc += data(i); },
+        Kokkos::Sum<int>(sum))
+        .get();
+  });
+
+  b.run(name("parallel_scan_async"), params, [&] {
+    hpx::kokkos::parallel_scan_async(
+        policy_type(inst, 0, n),
+        KOKKOS_LAMBDA(int i, int &update, bool const) { update += i; })
+        .get();
+  });
+
+  b.run(name("deep_copy_async_to_host"), params, [&] {
+    hpx::kokkos::deep_copy_async(inst, data_host, data).get();
+  });
+
+  b.run(name("deep_copy_async_from_host"), params, [&] {
+    hpx::kokkos::deep_copy_async(inst, data, data_host).get();
+  });
+
+  b.run(name("deep_copy_async_dependency"), params, [&] {
+    hpx::kokkos::deep_copy_async(hpx::make_ready_future(), inst, data_host,
+                                 data)
+        .get();
+  });
+
+  b.run(name("executor_post"), params, [&] {
+    hpx::parallel::execution::post(exec, KOKKOS_LAMBDA() {});
+    inst.fence();
+  });
+
+  b.run(name("executor_async_execute"), params, [&] {
+    hpx::parallel::execution::async_execute(exec, KOKKOS_LAMBDA() {}).get();
+  });
+
+  b.run(name("executor_bulk_async_execute"), params, [&] {
+    hpx::wait_all(hpx::parallel::execution::bulk_async_execute(
+        exec, KOKKOS_LAMBDA(int i) { data(i) = i; }, n));
+  });
+
+  b.run(name("for_loop"), params, [&] {
+    hpx::experimental::for_loop(hpx::kokkos::kok.on(exec), 0, n,
+                                KOKKOS_LAMBDA(int i) { data(i) = i; });
+  });
+
+  b.run(name("for_loop_task"), params, [&] {
+    hpx::experimental::for_loop(hpx::kokkos::kok(hpx::execution::task).on(exec),
+                                0, n, KOKKOS_LAMBDA(int i) { data(i) = i; })
+        .get();
+  });
+
+  b.run(name("reduce"), params, [&] {
+    hpx::reduce(hpx::kokkos::kok.on(exec), data.data(), data.data() + n, 0,
+                KOKKOS_LAMBDA(int x, int y) { return x + y; });
+  });
+
+  b.run(name("reduce_task"), params, [&] {
+    hpx::reduce(hpx::kokkos::kok(hpx::execution::task).on(exec), data.data(),
+                data.data() + n, 0,
+                KOKKOS_LAMBDA(int x, int y) { return x + y; })
+        .get();
+  });
+
+  b.run(name("get_future"), params,
+        [&] { hpx::kokkos::get_future<>(inst).get(); });
+
+  hpx::kokkos::graph<ExecutionSpace> g(inst);
+  g.capture([&](ExecutionSpace const &space) {
+    hpx::kokkos::parallel_for_async(policy_type(space, 0, n),
+                                    KOKKOS_LAMBDA(int i) { data(i) = i; });
+    hpx::kokkos::parallel_for_async(policy_type(space, 0, n),
+                                    KOKKOS_LAMBDA(int i) { data(i) += i; });
+  });
+  b.run(name("graph_launch"), params, [&] { g.launch().get(); });
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  int result = 0;
+  {
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
+
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &inst) {
+      for (auto const n : b.sizes({1, 1000, 1000000})) {
+        test_entry_points(b, inst, n);
+      }
+    });
+
+    result = b.report();
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -4,69 +4,305 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 /// \file
-/// Benchmarks the creation and synchronization of an execution space-specific
-/// future.
+/// Benchmarks the creation and synchronization of execution space-specific
+/// futures. Every strategy for completing a future that is available for an
+/// execution space is measured, independently of the strategy selected at
+/// configuration time. For each strategy the benchmark measures the cost of
+/// creating the future, the latency from launching a kernel to observing its
+/// completion with different ways of waiting, and the throughput with many
+/// futures outstanding. The strategies that depend on polling are also
+/// measured with polling from the scheduler loop, without polling where they
+/// do not need it, and with adaptive polling at several backoff settings.
+
+#include "benchmark.hpp"
 
 #include <Kokkos_Core.hpp>
-#include <hpx/chrono.hpp>
+#include <hpx/future.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
+#include <hpx/thread.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Calls f with the name of every future strategy available for
+/// ExecutionSpace and a callable creating a future with that strategy.
+template <typename ExecutionSpace, typename F> void for_each_strategy(F &&f) {
+  // Generic fallback used for execution spaces without asynchronous support
+  f("fence", [](ExecutionSpace const &inst) {
+    inst.fence();
+    return hpx::shared_future<void>(hpx::make_ready_future());
+  });
+  // The strategy selected at configuration time
+  f("default", [](ExecutionSpace const &inst) {
+    return hpx::kokkos::get_future<>(inst);
+  });
+
+#if defined(KOKKOS_ENABLE_CUDA)
+  if constexpr (std::is_same<ExecutionSpace, Kokkos::Cuda>::value) {
+    f("cuda_event", [](Kokkos::Cuda const &inst) {
+      return hpx::shared_future<void>(
+          hpx::cuda::experimental::detail::get_future_with_event(
+              inst.cuda_stream()));
+    });
+    f("cuda_callback", [](Kokkos::Cuda const &inst) {
+      return hpx::shared_future<void>(
+          hpx::cuda::experimental::detail::get_future_with_callback(
+              inst.cuda_stream()));
+    });
+  }
+#endif
 
-void print_header() {
-  std::cout << "test_name,execution_space,subtest_name,time" << std::endl;
+#if defined(KOKKOS_ENABLE_HIP)
+  if constexpr (std::is_same<ExecutionSpace,
+                             Kokkos::Experimental::HIP>::value) {
+    f("hip_event", [](Kokkos::Experimental::HIP const &inst) {
+      return hpx::shared_future<void>(
+          hpx::cuda::experimental::detail::get_future_with_event(
+              inst.hip_stream()));
+    });
+    f("hip_callback", [](Kokkos::Experimental::HIP const &inst) {
+      return hpx::shared_future<void>(
+          hpx::cuda::experimental::detail::get_future_with_callback(
+              inst.hip_stream()));
+    });
+  }
+#endif
+
+#if defined(KOKKOS_ENABLE_SYCL)
+  if constexpr (std::is_same<ExecutionSpace,
+                             Kokkos::Experimental::SYCL>::value) {
+    f("sycl_event", [](Kokkos::Experimental::SYCL const &inst) {
+      return hpx::shared_future<void>(
+          hpx::sycl::experimental::detail::get_future(inst.sycl_queue()));
+    });
+    f("sycl_host_task", [](Kokkos::Experimental::SYCL const &inst) {
+      return hpx::shared_future<void>(
+          hpx::sycl::experimental::detail::get_future_using_host_task(
+              inst.sycl_queue()));
+    });
+  }
+#endif
+
+#if defined(KOKKOS_ENABLE_HPX)
+  if constexpr (std::is_same<ExecutionSpace,
+                             Kokkos::Experimental::HPX>::value) {
+    f("hpx_impl_get_future", [](Kokkos::Experimental::HPX const &inst) {
+      return hpx::shared_future<void>(inst.impl_get_future());
+    });
+  }
+#endif
 }
 
 template <typename ExecutionSpace>
-void print_result(std::string const &label, ExecutionSpace const &inst,
-                  double time) {
-  std::cout << "future_overhead," << inst.name() << "," << label << "," << time
-            << std::endl;
+void launch_empty_kernel(ExecutionSpace const &inst) {
+  Kokkos::parallel_for("empty", Kokkos::RangePolicy<ExecutionSpace>(inst, 0, 1),
+                       KOKKOS_LAMBDA(int){});
 }
 
-template <typename ExecutionSpace>
-void test_future_get(ExecutionSpace const &inst) {
-  hpx::chrono::high_resolution_timer timer;
-  hpx::kokkos::get_future<>(inst).get();
-  print_result("future_get", inst, timer.elapsed());
+/// Waits for f in one of the ways a future can be observed to be ready.
+/// Polling for completion happens on the waiting thread for spin, and from
+/// the HPX scheduler otherwise.
+void wait(std::string const &mode, hpx::shared_future<void> const &f) {
+  if (mode == "get") {
+    f.get();
+  } else if (mode == "spin") {
+    while (!f.is_ready()) {
+      hpx::this_thread::yield();
+    }
+  } else if (mode == "then_sync") {
+    f.then(hpx::launch::sync, [](auto &&) {}).get();
+  } else {
+    f.then(hpx::launch::async, [](auto &&) {}).get();
+  }
+}
+
+/// A way of polling for the completion of futures.
+struct polling_configuration {
+  char const *name;
+  bool scheduler;
+  bool adaptive;
+  hpx::kokkos::polling_parameters parameters;
+};
+
+std::vector<polling_configuration> polling_configurations() {
+  using std::chrono::microseconds;
+  using std::chrono::milliseconds;
+  using std::chrono::nanoseconds;
+  return {{"scheduler", true, false, {}},
+          {"none", false, false, {}},
+          {"adaptive_10us", false, true,
+           {nanoseconds(microseconds(1)), nanoseconds(microseconds(10)), 2.0}},
+          {"adaptive_100us", false, true,
+           {nanoseconds(microseconds(1)), nanoseconds(microseconds(100)), 2.0}},
+          {"adaptive_1ms", false, true,
+           {nanoseconds(microseconds(1)), nanoseconds(milliseconds(1)), 2.0}}};
 }
 
+/// Applies a polling configuration to the default pool for the lifetime of
+/// the object, and restores the previous configuration afterwards.
+class polling_configuration_scope {
+public:
+  explicit polling_configuration_scope(polling_configuration const &c)
+      : scheduler(hpx::kokkos::polling_enabled()),
+        adaptive(hpx::kokkos::adaptive_polling_enabled()),
+        parameters(hpx::kokkos::get_polling_parameters()) {
+    set_scheduler_polling(scheduler, c.scheduler);
+    hpx::kokkos::enable_adaptive_polling(c.adaptive);
+    hpx::kokkos::set_polling_parameters(c.parameters);
+  }
+
+  ~polling_configuration_scope() {
+    set_scheduler_polling(hpx::kokkos::polling_enabled(), scheduler);
+    hpx::kokkos::enable_adaptive_polling(adaptive);
+    hpx::kokkos::set_polling_parameters(parameters);
+  }
+
+  polling_configuration_scope(polling_configuration_scope const &) = delete;
+  polling_configuration_scope &
+  operator=(polling_configuration_scope const &) = delete;
+
+private:
+  static void set_scheduler_polling(bool current, bool enable) {
+    if (enable && !current) {
+      hpx::kokkos::enable_polling();
+    } else if (!enable && current) {
+      hpx::kokkos::disable_polling();
+    }
+  }
+
+  bool scheduler;
+  bool adaptive;
+  hpx::kokkos::polling_parameters parameters;
+};
+
+/// Measures the strategies that depend on polling under every polling
+/// configuration. Event futures are completed only by polling, so they are
+/// not measured without it.
 template <typename ExecutionSpace>
-void test_future_then_sync(ExecutionSpace const &inst) {
-  hpx::chrono::high_resolution_timer timer;
-  auto f = hpx::kokkos::get_future<>(inst);
-  f.then(hpx::launch::sync, [&](auto &&f) {
-     print_result("future_then_sync", inst, timer.elapsed());
-   }).get();
+void test_polling(hpx::kokkos::detail::benchmark_runner &b,
+                  ExecutionSpace const &inst) {
+  std::vector<hpx::kokkos::future_strategy> strategies{
+      hpx::kokkos::future_strategy::fence};
+  // Only device execution spaces have events
+  if (!Kokkos::SpaceAccessibility<ExecutionSpace,
+                                  Kokkos::HostSpace>::accessible) {
+    strategies.push_back(hpx::kokkos::future_strategy::event);
+  }
+
+  for (auto const &c : polling_configurations()) {
+    polling_configuration_scope scope(c);
+    for (auto const s : strategies) {
+      if (s == hpx::kokkos::future_strategy::event && !c.scheduler &&
+          !c.adaptive) {
+        continue;
+      }
+
+      hpx::kokkos::detail::benchmark_parameters const params{
+          {"space", inst.name()},
+          {"strategy", hpx::kokkos::to_string(s)},
+          {"polling", c.name}};
+
+      b.run("future_overheads/polling_completion", params, [&] {
+        launch_empty_kernel(inst);
+        hpx::kokkos::get_future(inst, s).get();
+      });
+
+      std::size_t const outstanding = 256;
+      std::vector<hpx::shared_future<void>> futures;
+      futures.reserve(outstanding);
+      auto *r = b.run(
+          "future_overheads/polling_throughput", params,
+          [&] { futures.clear(); },
+          [&] {
+            for (std::size_t i = 0; i < outstanding; ++i) {
+              launch_empty_kernel(inst);
+              futures.push_back(hpx::kokkos::get_future(inst, s));
+            }
+            hpx::wait_all(futures);
+          });
+      if (r != nullptr) {
+        r->metrics["futures_per_second"] = outstanding / r->time.median;
+      }
+    }
+  }
 }
 
 template <typename ExecutionSpace>
-void test_future_then_async(ExecutionSpace const &inst) {
-  hpx::chrono::high_resolution_timer timer;
-  auto f = hpx::kokkos::get_future<>(inst);
-  f.then(hpx::launch::async, [&](auto &&f) {
-     print_result("future_then_async", inst, timer.elapsed());
-   }).get();
+void test_future(hpx::kokkos::detail::benchmark_runner &b,
+                 ExecutionSpace const &inst) {
+  for_each_strategy<ExecutionSpace>([&](char const *strategy,
+                                        auto const &get_future) {
+    hpx::kokkos::detail::benchmark_parameters const params{
+        {"space", inst.name()}, {"strategy", strategy}};
+
+    // Cost of creating the future, with a kernel in flight
+    hpx::shared_future<void> f = hpx::make_ready_future();
+    b.run(
+        "future_overheads/enqueue", params,
+        [&] {
+          f.get();
+          launch_empty_kernel(inst);
+        },
+        [&] { f = get_future(inst); });
+    f.get();
+
+    // Latency from launching a kernel to observing its completion
+    for (char const *mode : {"get", "spin", "then_sync", "then_async"}) {
+      auto mode_params = params;
+      mode_params.emplace_back("wait", mode);
+      b.run("future_overheads/completion", mode_params, [&] {
+        launch_empty_kernel(inst);
+        wait(mode, get_future(inst));
+      });
+    }
+
+    // Throughput with many futures outstanding
+    for (std::size_t outstanding : {1, 16, 256}) {
+      auto throughput_params = params;
+      throughput_params.emplace_back("outstanding",
+                                     std::to_string(outstanding));
+      std::vector<hpx::shared_future<void>> futures;
+      futures.reserve(outstanding);
+      auto *r = b.run(
+          "future_overheads/throughput", throughput_params,
+          [&] { futures.clear(); },
+          [&] {
+            for (std::size_t i = 0; i < outstanding; ++i) {
+              launch_empty_kernel(inst);
+              futures.push_back(get_future(inst));
+            }
+            hpx::wait_all(futures);
+          });
+      if (r != nullptr) {
+        r->metrics["futures_per_second"] = outstanding / r->time.median;
+      }
+    }
+  });
 }
 
 int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
+  int result = 0;
   {
-    hpx::kokkos::detail::polling_helper p;
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
 
-    print_header();
-    for (int r = 1; r <= 100; ++r) {
-      test_future_get(Kokkos::DefaultExecutionSpace());
-      test_future_then_sync(Kokkos::DefaultExecutionSpace());
-      test_future_then_async(Kokkos::DefaultExecutionSpace());
-    }
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &inst) {
+      test_future(b, inst);
+      test_polling(b, inst);
+    });
+
+    result = b.report();
   }
 
   Kokkos::finalize();
   hpx::finalize();
 
-  return 0;
+  return result;
 }
 
 int main(int argc, char *argv[]) {
@@ -13,29 +13,14 @@
 /// on the same execution space instance to see the effects of hiding latencies
 /// of multiple launches.
 
+#include "benchmark.hpp"
+
 #include <Kokkos_Core.hpp>
 #include <hpx/algorithm.hpp>
 #include <hpx/chrono.hpp>
 #include <hpx/config.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
-
-void print_header() {
-  std::cout << "test_name,execution_space,subtest_name,vector_size,launches_"
-               "per_test,time"
-            << std::endl;
-}
-
-template <typename ExecutionSpace, typename F, typename Views, typename... Args>
-void time_test(std::string const &label, F const &f, ExecutionSpace const &inst,
-               Views const &views, int const n, int const launches_per_test,
-               Args... args) {
-  hpx::chrono::high_resolution_timer timer;
-  f(inst, views, n, launches_per_test, std::forward<Args>(args)...);
-  std::cout << "overhead," << inst.name() << "," << label << "," << n << ","
-            << launches_per_test << "," << timer.elapsed() << std::endl;
-}
 
 // Plain Kokkos::parallel_for, with a fence at the end.
 template <typename ExecutionSpace, typename Views>
@@ -109,16 +94,18 @@ void test_for_loop_kokkos_async(ExecutionSpace const &inst, Views const &views,
 }
 
 // hpx::for_each with a Kokkos execution policy, synchronized either with a
-// fence or the returned futures.
+// fence or the returned futures. Ranges with at most inline_threshold elements
+// run inline on the calling thread.
 template <typename ExecutionSpace, typename Views>
 void test_for_loop_hpx_async(ExecutionSpace const &inst, Views const &views,
                              int const n, int const launches_per_test,
-                             sync_type s) {
+                             sync_type s, std::size_t inline_threshold = 0) {
   std::vector<hpx::shared_future<void>> futures;
   futures.reserve(launches_per_test);
 
   hpx::kokkos::executor<typename std::decay<ExecutionSpace>::type> exec(inst);
   auto policy = hpx::kokkos::kok(hpx::execution::task).on(exec);
+  policy.inline_threshold(inline_threshold);
 
   for (int l = 0; l < launches_per_test; ++l) {
     futures.push_back(
@@ -142,8 +129,9 @@ void test_for_loop_hpx_async(ExecutionSpace const &inst, Views const &views,
 }
 
 template <typename ExecutionSpace>
-void test_for_loop(ExecutionSpace const &inst, int const n,
-                   int const launches_per_test, int const repetitions) {
+void test_for_loop(hpx::kokkos::detail::benchmark_runner &b,
+                   ExecutionSpace const &inst, int const n,
+                   int const launches_per_test) {
   std::vector<Kokkos::View<int *, typename std::decay<ExecutionSpace>::type>>
       views;
   views.reserve(launches_per_test);
@@ -151,46 +139,66 @@ void test_for_loop(ExecutionSpace const &inst, int const n,
     views.emplace_back("a", n);
   }
 
-  for (int r = 0; r < repetitions; ++r) {
-    time_test("kokkos", &test_for_loop_kokkos<decltype(inst), decltype(views)>,
-              inst, views, n, launches_per_test);
-    time_test("kokkos_future",
-              &test_for_loop_kokkos_future<decltype(inst), decltype(views)>,
-              inst, views, n, launches_per_test);
-    time_test("kokkos_async_fence",
-              &test_for_loop_kokkos_async<decltype(inst), decltype(views)>,
-              inst, views, n, launches_per_test, sync_type::fence);
-    time_test("kokkos_async_future",
-              &test_for_loop_kokkos_async<decltype(inst), decltype(views)>,
-              inst, views, n, launches_per_test, sync_type::future);
-    time_test("hpx_async_fence",
-              &test_for_loop_hpx_async<decltype(inst), decltype(views)>, inst,
-              views, n, launches_per_test, sync_type::fence);
-    time_test("hpx_async_future",
-              &test_for_loop_hpx_async<decltype(inst), decltype(views)>, inst,
-              views, n, launches_per_test, sync_type::future);
-  }
+  hpx::kokkos::detail::benchmark_parameters const params{
+      {"space", inst.name()},
+      {"size", std::to_string(n)},
+      {"launches", std::to_string(launches_per_test)}};
+
+  b.run("overheads/kokkos", params, [&] {
+    test_for_loop_kokkos(inst, views, n, launches_per_test);
+  });
+  b.run("overheads/kokkos_future", params, [&] {
+    test_for_loop_kokkos_future(inst, views, n, launches_per_test);
+  });
+  b.run("overheads/kokkos_async_fence", params, [&] {
+    test_for_loop_kokkos_async(inst, views, n, launches_per_test,
+                               sync_type::fence);
+  });
+  b.run("overheads/kokkos_async_future", params, [&] {
+    test_for_loop_kokkos_async(inst, views, n, launches_per_test,
+                               sync_type::future);
+  });
+  b.run("overheads/hpx_async_fence", params, [&] {
+    test_for_loop_hpx_async(inst, views, n, launches_per_test,
+                            sync_type::fence);
+  });
+  b.run("overheads/hpx_async_future", params, [&] {
+    test_for_loop_hpx_async(inst, views, n, launches_per_test,
+                            sync_type::future);
+  });
+  b.run("overheads/hpx_inline_future", params, [&] {
+    test_for_loop_hpx_async(inst, views, n, launches_per_test,
+                            sync_type::future,
+                            hpx::kokkos::default_inline_threshold);
+  });
 }
 
 int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
+  // The inline benchmark uses the global threshold
+  hpx::kokkos::calibrate_inline_threshold();
 
+  int result = 0;
   {
-    hpx::kokkos::detail::polling_helper p;
-
-    print_header();
-    hpx::kokkos::kokkos_instance_helper<> h;
-    for (int n = 1; n <= 100000; n *= 10) {
-      for (int l = 1; l <= (1 << 10); l *= 2) {
-        test_for_loop(h.get_execution_space(), n, l, 3);
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
+
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &space) {
+      using execution_space = typename std::decay<decltype(space)>::type;
+      hpx::kokkos::kokkos_instance_helper<execution_space> h;
+      for (auto const n : b.sizes({1, 10, 100, 1000, 10000, 100000})) {
+        for (int l = 1; l <= (1 << 10); l *= 2) {
+          test_for_loop(b, h.get_execution_space(), n, l);
+        }
       }
-    }
+    });
+
+    result = b.report();
   }
 
   Kokkos::finalize();
   hpx::finalize();
 
-  return 0;
+  return result;
 }
 
 int main(int argc, char *argv[]) {
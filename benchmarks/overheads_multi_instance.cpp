@@ -7,30 +7,13 @@
 /// This test is like the overheads test but instead of using a single instance
 /// for all launches it uses the instances provided by kokkos_instance_helper.
 
+#include "benchmark.hpp"
+
 #include <Kokkos_Core.hpp>
 #include <hpx/algorithm.hpp>
 #include <hpx/chrono.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
-
-void print_header() {
-  std::cout << "test_name,execution_space,subtest_name,vector_size,launches_"
-               "per_test,time"
-            << std::endl;
-}
-
-template <typename ExecutionSpace, typename F, typename Views, typename... Args>
-void time_test(std::string const &label, F const &f,
-               hpx::kokkos::kokkos_instance_helper<ExecutionSpace> &h,
-               Views const &views, int const n, int const launches_per_test,
-               Args... args) {
-  hpx::chrono::high_resolution_timer timer;
-  f(h, views, n, launches_per_test, std::forward<Args>(args)...);
-  std::cout << "overhead_multi_instance," << ExecutionSpace().name() << ","
-            << label << "," << n << "," << launches_per_test << ","
-            << timer.elapsed() << std::endl;
-}
 
 // Plain Kokkos::parallel_for, with a fence at the end.
 template <typename ExecutionSpace, typename Views>
@@ -118,58 +101,64 @@ void test_for_loop_hpx_async(
 }
 
 template <typename ExecutionSpace>
-void test_for_loop(hpx::kokkos::kokkos_instance_helper<ExecutionSpace> &h,
-                   int const n, int const launches_per_test,
-                   int const repetitions) {
+void test_for_loop(hpx::kokkos::detail::benchmark_runner &b,
+                   hpx::kokkos::kokkos_instance_helper<ExecutionSpace> &h,
+                   int const n, int const launches_per_test) {
   std::vector<Kokkos::View<int *, ExecutionSpace>> views;
   views.reserve(launches_per_test);
   for (int l = 0; l < launches_per_test; ++l) {
     views.emplace_back("a", n);
   }
 
-  for (int r = 0; r < repetitions; ++r) {
-    time_test<ExecutionSpace>(
-        "kokkos", &test_for_loop_kokkos<ExecutionSpace, decltype(views)>, h,
-        views, n, launches_per_test);
-    time_test<ExecutionSpace>(
-        "kokkos_async_fence",
-        &test_for_loop_kokkos_async<ExecutionSpace, decltype(views)>, h, views,
-        n, launches_per_test, sync_type::fence);
-    time_test<ExecutionSpace>(
-        "kokkos_async_future",
-        &test_for_loop_kokkos_async<ExecutionSpace, decltype(views)>, h, views,
-        n, launches_per_test, sync_type::future);
-    time_test<ExecutionSpace>(
-        "hpx_async_fence",
-        &test_for_loop_hpx_async<ExecutionSpace, decltype(views)>, h, views, n,
-        launches_per_test, sync_type::fence);
-    time_test<ExecutionSpace>(
-        "hpx_async_future",
-        &test_for_loop_hpx_async<ExecutionSpace, decltype(views)>, h, views, n,
-        launches_per_test, sync_type::future);
-  }
+  hpx::kokkos::detail::benchmark_parameters const params{
+      {"space", ExecutionSpace::name()},
+      {"size", std::to_string(n)},
+      {"launches", std::to_string(launches_per_test)}};
+
+  b.run("overheads_multi_instance/kokkos", params, [&] {
+    test_for_loop_kokkos(h, views, n, launches_per_test);
+  });
+  b.run("overheads_multi_instance/kokkos_async_fence", params, [&] {
+    test_for_loop_kokkos_async(h, views, n, launches_per_test,
+                               sync_type::fence);
+  });
+  b.run("overheads_multi_instance/kokkos_async_future", params, [&] {
+    test_for_loop_kokkos_async(h, views, n, launches_per_test,
+                               sync_type::future);
+  });
+  b.run("overheads_multi_instance/hpx_async_fence", params, [&] {
+    test_for_loop_hpx_async(h, views, n, launches_per_test, sync_type::fence);
+  });
+  b.run("overheads_multi_instance/hpx_async_future", params, [&] {
+    test_for_loop_hpx_async(h, views, n, launches_per_test,
+                            sync_type::future);
+  });
 }
 
 int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
+  int result = 0;
   {
-    hpx::kokkos::detail::polling_helper p;
-
-    print_header();
-    hpx::kokkos::kokkos_instance_helper<Kokkos::DefaultExecutionSpace> h;
-    test_for_loop(h, 1, 10, 10);
-    for (int n = 1; n <= 100000; n *= 10) {
-      for (int l = 1; l <= (1 << 10); l *= 2) {
-        test_for_loop(h, n, l, 3);
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
+
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &space) {
+      using execution_space = typename std::decay<decltype(space)>::type;
+      hpx::kokkos::kokkos_instance_helper<execution_space> h;
+      for (auto const n : b.sizes({1, 10, 100, 1000, 10000, 100000})) {
+        for (int l = 1; l <= (1 << 10); l *= 2) {
+          test_for_loop(b, h, n, l);
+        }
       }
-    }
+    });
+
+    result = b.report();
   }
 
   Kokkos::finalize();
   hpx::finalize();
 
-  return 0;
+  return result;
 }
 
 int main(int argc, char *argv[]) {
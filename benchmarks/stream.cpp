@@ -9,54 +9,73 @@
 // This code is based on the STREAM benchmark:
 // https://www.cs.virginia.edu/stream/ref.html
 
+#include "benchmark.hpp"
+
 #include <Kokkos_Core.hpp>
 #include <hpx/algorithm.hpp>
 #include <hpx/chrono.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
+
+#include <algorithm>
+#include <string>
 
 using elem_type = double;
-using view_type = Kokkos::View<elem_type *>;
-using host_view_type = Kokkos::View<elem_type *>::HostMirror;
 
-void print_header() {
-  std::cout << "test_name,execution_space,subtest_name,step_name,vector_size,"
-               "element_size,num_stores_loads,time"
-            << std::endl;
-}
+template <typename ExecutionSpace> struct stream_views {
+  using view_type = Kokkos::View<elem_type *, ExecutionSpace>;
+  using host_view_type = typename view_type::HostMirror;
+
+  explicit stream_views(std::size_t size)
+      : a("a", size), b("b", size), c("c", size),
+        ah(Kokkos::create_mirror_view(a)), bh(Kokkos::create_mirror_view(b)),
+        ch(Kokkos::create_mirror_view(c)) {}
+
+  // Places blocks of the views on the NUMA domains of the instances of exec
+  // by first touch
+  stream_views(hpx::kokkos::numa_executor<ExecutionSpace> const &exec,
+               std::size_t size)
+      : a(hpx::kokkos::make_first_touch_view<view_type>(exec, "a", size)),
+        b(hpx::kokkos::make_first_touch_view<view_type>(exec, "b", size)),
+        c(hpx::kokkos::make_first_touch_view<view_type>(exec, "c", size)),
+        ah(Kokkos::create_mirror_view(a)), bh(Kokkos::create_mirror_view(b)),
+        ch(Kokkos::create_mirror_view(c)) {}
 
-template <typename F, typename Step>
-void time_test(std::string const &label, F const &f, Step const &step) {
-  hpx::chrono::high_resolution_timer timer;
-  f(step);
-  std::cout << "stream," << Kokkos::DefaultExecutionSpace().name() << ","
-            << label << "," << step.name << "," << step.a.extent(0) << ","
-            << sizeof(elem_type) << "," << step.num_stores_loads << ","
-            << timer.elapsed() << std::endl;
-}
+  view_type a;
+  view_type b;
+  view_type c;
+  host_view_type ah;
+  host_view_type bh;
+  host_view_type ch;
+};
 
-void init(view_type a, view_type b, view_type c, host_view_type ah,
-          host_view_type bh, host_view_type ch) {
+template <typename Views> void init(Views &v) {
+  auto ah = v.ah;
+  auto bh = v.bh;
+  auto ch = v.ch;
   Kokkos::parallel_for(
       "init",
-      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, a.extent(0)),
+      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, v.a.extent(0)),
       KOKKOS_LAMBDA(int i) {
         ah[i] = 1.0;
         bh[i] = 2.0;
         ch[i] = 0.0;
       });
 
-  Kokkos::deep_copy(a, ah);
-  Kokkos::deep_copy(b, bh);
-  Kokkos::deep_copy(c, ch);
+  Kokkos::deep_copy(v.a, v.ah);
+  Kokkos::deep_copy(v.b, v.bh);
+  Kokkos::deep_copy(v.c, v.ch);
 }
 
-void check_results(view_type a, view_type b, view_type c, host_view_type ah,
-                   host_view_type bh, host_view_type ch) {
-  Kokkos::deep_copy(ah, a);
-  Kokkos::deep_copy(bh, b);
-  Kokkos::deep_copy(ch, c);
+template <typename Views> void check_results(Views &v) {
+  Kokkos::deep_copy(v.ah, v.a);
+  Kokkos::deep_copy(v.bh, v.b);
+  Kokkos::deep_copy(v.ch, v.c);
+
+  auto const &a = v.a;
+  auto const &ah = v.ah;
+  auto const &bh = v.bh;
+  auto const &ch = v.ch;
 
   elem_type aj, bj, cj, scalar;
   elem_type aSumErr, bSumErr, cSumErr;
@@ -160,10 +179,10 @@ void check_results(view_type a, view_type b, view_type c, host_view_type ah,
   }
 }
 
-struct copy_step {
-  view_type a;
-  view_type b;
-  view_type c;
+template <typename View> struct copy_step {
+  View a;
+  View b;
+  View c;
 
   static constexpr int num_stores_loads = 2;
   static constexpr char const *name = "copy";
@@ -171,10 +190,10 @@ struct copy_step {
   KOKKOS_INLINE_FUNCTION void operator()(int i) const { c[i] = a[i]; }
 };
 
-struct scale_step {
-  view_type a;
-  view_type b;
-  view_type c;
+template <typename View> struct scale_step {
+  View a;
+  View b;
+  View c;
 
   static constexpr int num_stores_loads = 2;
   static constexpr char const *name = "scale";
@@ -184,10 +203,10 @@ struct scale_step {
   KOKKOS_INLINE_FUNCTION void operator()(int i) const { b[i] = scalar * c[i]; }
 };
 
-struct add_step {
-  view_type a;
-  view_type b;
-  view_type c;
+template <typename View> struct add_step {
+  View a;
+  View b;
+  View c;
 
   static constexpr int num_stores_loads = 3;
   static constexpr char const *name = "add";
@@ -195,10 +214,10 @@ struct add_step {
   KOKKOS_INLINE_FUNCTION void operator()(int i) const { c[i] = a[i] + b[i]; }
 };
 
-struct triad_step {
-  view_type a;
-  view_type b;
-  view_type c;
+template <typename View> struct triad_step {
+  View a;
+  View b;
+  View c;
 
   static constexpr int num_stores_loads = 3;
   static constexpr char const *name = "triad";
@@ -210,163 +229,147 @@ struct triad_step {
   }
 };
 
-// Plain Kokkos::parallel_for.
-template <typename Step> void test_stream_kokkos_fence_impl(Step step) {
-  Kokkos::parallel_for(Kokkos::RangePolicy<>(0, step.a.extent(0)), step);
-  Kokkos::fence();
-}
-
-void test_stream_kokkos_fence(std::string const &label, view_type a,
-                              view_type b, view_type c) {
-  time_test(label, &test_stream_kokkos_fence_impl<copy_step>,
-            copy_step{a, b, c});
-  time_test(label, &test_stream_kokkos_fence_impl<scale_step>,
-            scale_step{a, b, c});
-  time_test(label, &test_stream_kokkos_fence_impl<add_step>, add_step{a, b, c});
-  time_test(label, &test_stream_kokkos_fence_impl<triad_step>,
-            triad_step{a, b, c});
-}
-
-// Plain Kokkos::parallel_for using a future for synchronization.
-template <typename Step> void test_stream_kokkos_future_impl(Step step) {
-  Kokkos::parallel_for(Kokkos::RangePolicy<>(0, step.a.extent(0)), step);
-  hpx::kokkos::get_future<>().get();
-}
-
-void test_stream_kokkos_future(std::string const &label, view_type a,
-                               view_type b, view_type c) {
-  time_test(label, &test_stream_kokkos_future_impl<copy_step>,
-            copy_step{a, b, c});
-  time_test(label, &test_stream_kokkos_future_impl<scale_step>,
-            scale_step{a, b, c});
-  time_test(label, &test_stream_kokkos_future_impl<add_step>,
-            add_step{a, b, c});
-  time_test(label, &test_stream_kokkos_future_impl<triad_step>,
-            triad_step{a, b, c});
-}
-
-// Futurized Kokkos::parallel_for using fence for synchronization.
-template <typename Step> void test_stream_kokkos_async_fence_impl(Step step) {
-  hpx::kokkos::parallel_for_async(Kokkos::RangePolicy<>(0, step.a.extent(0)),
-                                  step);
-  Kokkos::fence();
-}
-
-void test_stream_kokkos_async_fence(std::string const &label, view_type a,
-                                    view_type b, view_type c) {
-  time_test(label, &test_stream_kokkos_async_fence_impl<copy_step>,
-            copy_step{a, b, c});
-  time_test(label, &test_stream_kokkos_async_fence_impl<scale_step>,
-            scale_step{a, b, c});
-  time_test(label, &test_stream_kokkos_async_fence_impl<add_step>,
-            add_step{a, b, c});
-  time_test(label, &test_stream_kokkos_async_fence_impl<triad_step>,
-            triad_step{a, b, c});
-}
-
-// Futurized Kokkos::parallel_for.
-template <typename Step> void test_stream_kokkos_async_future_impl(Step step) {
-  hpx::kokkos::parallel_for_async(Kokkos::RangePolicy<>(0, step.a.extent(0)),
-                                  step)
-      .get();
-}
-
-void test_stream_kokkos_async_future(std::string const &label, view_type a,
-                                     view_type b, view_type c) {
-  time_test(label, &test_stream_kokkos_async_future_impl<copy_step>,
-            copy_step{a, b, c});
-  time_test(label, &test_stream_kokkos_async_future_impl<scale_step>,
-            scale_step{a, b, c});
-  time_test(label, &test_stream_kokkos_async_future_impl<add_step>,
-            add_step{a, b, c});
-  time_test(label, &test_stream_kokkos_async_future_impl<triad_step>,
-            triad_step{a, b, c});
-}
-
-// Synchronous HPX for_loop.
-template <typename Step> void test_stream_hpx_impl(Step step) {
-  hpx::experimental::for_loop(hpx::kokkos::kok, 0, step.a.extent(0), step);
-}
-
-void test_stream_hpx(std::string const &label, view_type a, view_type b,
-                     view_type c) {
-  time_test(label, &test_stream_hpx_impl<copy_step>, copy_step{a, b, c});
-  time_test(label, &test_stream_hpx_impl<scale_step>, scale_step{a, b, c});
-  time_test(label, &test_stream_hpx_impl<add_step>, add_step{a, b, c});
-  time_test(label, &test_stream_hpx_impl<triad_step>, triad_step{a, b, c});
-}
-
-// Asynchronous HPX for_loop.
-template <typename Step> void test_stream_hpx_future_impl(Step step) {
-  hpx::experimental::for_loop(hpx::kokkos::kok(hpx::execution::task), 0,
-                              step.a.extent(0), step)
-      .get();
+// Times a single step. Every step is idempotent given the results of the
+// previous steps, so repeating a step does not change the final results.
+template <typename ExecutionSpace, typename Step, typename Launch>
+bool run_step(hpx::kokkos::detail::benchmark_runner &b,
+              std::string const &variant, Step const &step,
+              Launch const &launch) {
+  auto const n = step.a.extent(0);
+  auto *r = b.run("stream/" + variant,
+                  {{"space", ExecutionSpace::name()},
+                   {"step", Step::name},
+                   {"size", std::to_string(n)}},
+                  [&] { launch(step); });
+  if (r == nullptr) {
+    return false;
+  }
+  r->metrics["bandwidth_gbs"] =
+      Step::num_stores_loads * sizeof(elem_type) * n / r->time.median / 1e9;
+  return true;
 }
 
-void test_stream_hpx_future(std::string const &label, view_type a, view_type b,
-                            view_type c) {
-  time_test(label, &test_stream_hpx_future_impl<copy_step>, copy_step{a, b, c});
-  time_test(label, &test_stream_hpx_future_impl<scale_step>,
-            scale_step{a, b, c});
-  time_test(label, &test_stream_hpx_future_impl<add_step>, add_step{a, b, c});
-  time_test(label, &test_stream_hpx_future_impl<triad_step>,
-            triad_step{a, b, c});
+// Runs all steps of the benchmark with the given way of launching a step,
+// and validates the results if all steps were run.
+template <typename ExecutionSpace, typename Launch>
+void test_stream_variant(hpx::kokkos::detail::benchmark_runner &b,
+                         std::string const &variant,
+                         stream_views<ExecutionSpace> &v,
+                         Launch const &launch) {
+  using view_type = typename stream_views<ExecutionSpace>::view_type;
+
+  init(v);
+  bool all = true;
+  all &= run_step<ExecutionSpace>(b, variant,
+                                  copy_step<view_type>{v.a, v.b, v.c}, launch);
+  all &= run_step<ExecutionSpace>(
+      b, variant, scale_step<view_type>{v.a, v.b, v.c}, launch);
+  all &= run_step<ExecutionSpace>(b, variant,
+                                  add_step<view_type>{v.a, v.b, v.c}, launch);
+  all &= run_step<ExecutionSpace>(
+      b, variant, triad_step<view_type>{v.a, v.b, v.c}, launch);
+  if (all) {
+    check_results(v);
+  }
 }
 
-void test_stream(int repetitions, int size) {
-  view_type a("a", size);
-  view_type b("b", size);
-  view_type c("c", size);
-
-  host_view_type ah = Kokkos::create_mirror_view(a);
-  host_view_type bh = Kokkos::create_mirror_view(b);
-  host_view_type ch = Kokkos::create_mirror_view(c);
-
-  for (int i = 0; i < repetitions; ++i) {
-    init(a, b, c, ah, bh, ch);
-    test_stream_kokkos_fence("kokkos_fence", a, b, c);
-    check_results(a, b, c, ah, bh, ch);
-
-    init(a, b, c, ah, bh, ch);
-    test_stream_kokkos_future("kokkos_future", a, b, c);
-    check_results(a, b, c, ah, bh, ch);
-
-    init(a, b, c, ah, bh, ch);
-    test_stream_kokkos_async_fence("kokkos_async_fence", a, b, c);
-    check_results(a, b, c, ah, bh, ch);
-
-    init(a, b, c, ah, bh, ch);
-    test_stream_kokkos_async_future("kokkos_async_future", a, b, c);
-    check_results(a, b, c, ah, bh, ch);
-
-    init(a, b, c, ah, bh, ch);
-    test_stream_hpx("hpx", a, b, c);
-    check_results(a, b, c, ah, bh, ch);
-
-    init(a, b, c, ah, bh, ch);
-    test_stream_hpx_future("hpx_future", a, b, c);
-    check_results(a, b, c, ah, bh, ch);
+template <typename ExecutionSpace>
+void test_stream(hpx::kokkos::detail::benchmark_runner &b,
+                 ExecutionSpace const &inst, std::size_t size) {
+  using policy_type = Kokkos::RangePolicy<ExecutionSpace>;
+  stream_views<ExecutionSpace> v(size);
+  hpx::kokkos::executor<ExecutionSpace> exec(inst);
+
+  // Plain Kokkos::parallel_for.
+  test_stream_variant(b, "kokkos_fence", v, [&](auto const &step) {
+    Kokkos::parallel_for(policy_type(inst, 0, size), step);
+    inst.fence();
+  });
+
+  // Plain Kokkos::parallel_for using a future for synchronization.
+  test_stream_variant(b, "kokkos_future", v, [&](auto const &step) {
+    Kokkos::parallel_for(policy_type(inst, 0, size), step);
+    hpx::kokkos::get_future(inst).get();
+  });
+
+  // Futurized Kokkos::parallel_for using fence for synchronization.
+  test_stream_variant(b, "kokkos_async_fence", v, [&](auto const &step) {
+    hpx::kokkos::parallel_for_async(policy_type(inst, 0, size), step);
+    inst.fence();
+  });
+
+  // Futurized Kokkos::parallel_for.
+  test_stream_variant(b, "kokkos_async_future", v, [&](auto const &step) {
+    hpx::kokkos::parallel_for_async(policy_type(inst, 0, size), step).get();
+  });
+
+  // Synchronous HPX for_loop.
+  test_stream_variant(b, "hpx", v, [&](auto const &step) {
+    hpx::experimental::for_loop(hpx::kokkos::kok.on(exec), 0, size, step);
+  });
+
+  // Asynchronous HPX for_loop.
+  test_stream_variant(b, "hpx_future", v, [&](auto const &step) {
+    hpx::experimental::for_loop(hpx::kokkos::kok(hpx::execution::task).on(exec),
+                                0, size, step)
+        .get();
+  });
+
+  // Synchronous HPX for_loop with one instance per NUMA domain, each bound to
+  // the thread pool of its domain and working on the block of the views
+  // placed on its domain. The NUMA thread pools leave a single core to the
+  // other variants, so they are only created with --numa-pools, and the
+  // variant is skipped without them.
+  if (hpx::kokkos::detail::get_numa_thread_pools(
+          hpx::kokkos::default_numa_thread_pool_prefix)
+          .empty()) {
+    return;
   }
+  hpx::kokkos::numa_executor<ExecutionSpace> numa_exec;
+  stream_views<ExecutionSpace> numa_v(numa_exec, size);
+  test_stream_variant(b, "hpx_numa", numa_v, [&](auto const &step) {
+    hpx::experimental::for_loop(hpx::kokkos::kok.on(numa_exec), 0, size, step);
+  });
 }
 
 int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
+  int result = 0;
   {
-    hpx::kokkos::detail::polling_helper p;
+    hpx::kokkos::detail::benchmark_runner b(argc, argv);
 
-    print_header();
-    for (int size = 1024; size <= (1024 << 11); size *= 2) {
-      test_stream(10, size);
+    std::vector<std::size_t> default_sizes;
+    for (std::size_t size = 1024; size <= (1024 << 11); size *= 2) {
+      default_sizes.push_back(size);
     }
+
+    hpx::kokkos::detail::for_each_execution_space([&](auto const &inst) {
+      for (auto const size : b.sizes(default_sizes)) {
+        test_stream(b, inst, size);
+      }
+    });
+
+    result = b.report();
   }
 
   Kokkos::finalize();
   hpx::finalize();
 
-  return 0;
+  return result;
 }
 
 int main(int argc, char *argv[]) {
-  return hpx::init(test_main, argc, argv);
+  // --numa-pools creates one thread pool per NUMA domain for the hpx_numa
+  // variant
+  hpx::init_params p;
+  if (std::find_if(argv + 1, argv + argc, [](char const *arg) {
+        return std::string(arg) == "--numa-pools";
+      }) != argv + argc) {
+    p.rp_callback = [](hpx::resource::partitioner &rp,
+                       hpx::program_options::variables_map const &) {
+      hpx::kokkos::create_numa_thread_pools(rp);
+    };
+  }
+  return hpx::init(test_main, argc, argv, p);
 }
@@ -10,15 +10,28 @@
 
 #pragma once
 
+#include <hpx/kokkos/autotune.hpp>
+#include <hpx/kokkos/co_executor.hpp>
 #include <hpx/kokkos/config.hpp>
+#include <hpx/kokkos/coroutine.hpp>
+#include <hpx/kokkos/dataflow.hpp>
 #include <hpx/kokkos/deep_copy.hpp>
+#include <hpx/kokkos/dependencies.hpp>
 #include <hpx/kokkos/detail/version.hpp>
 #include <hpx/kokkos/execution_spaces.hpp>
 #include <hpx/kokkos/executors.hpp>
 #include <hpx/kokkos/future.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/graph.hpp>
 #include <hpx/kokkos/hpx_algorithms.hpp>
 #include <hpx/kokkos/import.hpp>
+#include <hpx/kokkos/inline_launch.hpp>
 #include <hpx/kokkos/instance_helper.hpp>
+#include <hpx/kokkos/instrumentation.hpp>
 #include <hpx/kokkos/kokkos_algorithms.hpp>
+#include <hpx/kokkos/numa.hpp>
+#include <hpx/kokkos/partitioning_executor.hpp>
 #include <hpx/kokkos/policy.hpp>
+#include <hpx/kokkos/polling.hpp>
+#include <hpx/kokkos/trace.hpp>
 #include <hpx/kokkos/view.hpp>
@@ -0,0 +1,404 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains autotuning of the launch parameters of HPX algorithms. Parameters
+/// are tuned per label, execution space, rank, and power-of-two bucket of the
+/// number of iterations. The first calls of each key try the candidates in
+/// turn, after which the fastest is used. Tuned parameters can be written to
+/// and read from a cache file.
+
+#pragma once
+
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/execution_spaces.hpp>
+
+#include <hpx/chrono.hpp>
+#include <hpx/future.hpp>
+#include <hpx/runtime.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// Launch parameters chosen by the autotuner.
+struct launch_parameters {
+  /// The number of chunks per thread of the execution space that
+  /// one-dimensional ranges are split into. Zero uses the Kokkos default.
+  std::size_t chunks_per_thread = 0;
+  /// The tile size of the last dimension of multi-dimensional ranges. Zero
+  /// uses the Kokkos default.
+  std::size_t tile_size = 0;
+  /// Whether the work items are hinted as light weight, as without tuning.
+  bool light_weight = true;
+};
+
+namespace detail {
+struct autotune_key {
+  std::string label;
+  std::string execution_space;
+  std::size_t rank;
+  std::size_t bucket;
+
+  bool operator<(autotune_key const &other) const {
+    return std::tie(label, execution_space, rank, bucket) <
+           std::tie(other.label, other.execution_space, other.rank,
+                    other.bucket);
+  }
+};
+
+struct autotune_entry {
+  std::vector<launch_parameters> candidates;
+  std::vector<std::uint64_t> time;
+  std::vector<std::size_t> samples;
+  std::size_t next = 0;
+  std::size_t best = 0;
+  bool tuned = false;
+};
+
+/// The parameters to use for one launch. If candidate is set the launch is
+/// part of the exploration of entry, and its time is recorded.
+struct autotune_selection {
+  launch_parameters parameters;
+  std::shared_ptr<autotune_entry> entry;
+  std::size_t candidate = 0;
+};
+
+/// Returns the power-of-two bucket of n, i.e. the position of its highest set
+/// bit.
+inline std::size_t autotune_bucket(std::size_t n) {
+  std::size_t bucket = 0;
+  while (n > 1) {
+    n >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+class autotuner {
+public:
+  static autotuner &get() {
+    static autotuner t;
+    return t;
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void enable(bool e) { enabled_.store(e, std::memory_order_relaxed); }
+
+  std::size_t samples() const {
+    return samples_.load(std::memory_order_relaxed);
+  }
+  void set_samples(std::size_t s) {
+    samples_.store((std::max)(s, std::size_t(1)), std::memory_order_relaxed);
+  }
+
+  autotune_selection select(char const *label,
+                            std::string const &execution_space,
+                            std::size_t rank, std::size_t n, bool host) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto &entry =
+        entries[autotune_key{label, execution_space, rank, autotune_bucket(n)}];
+    if (!entry) {
+      entry = std::make_shared<autotune_entry>();
+      entry->candidates = candidates(rank, host);
+      entry->time.resize(entry->candidates.size(), 0);
+      entry->samples.resize(entry->candidates.size(), 0);
+    }
+    if (entry->tuned) {
+      return autotune_selection{entry->candidates[entry->best], nullptr, 0};
+    }
+    std::size_t const c = entry->next++ % entry->candidates.size();
+    return autotune_selection{entry->candidates[c], entry, c};
+  }
+
+  void record(autotune_selection const &s, std::uint64_t time) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto &entry = *s.entry;
+    if (entry.tuned) {
+      return;
+    }
+    entry.time[s.candidate] += time;
+    ++entry.samples[s.candidate];
+    for (auto const samples : entry.samples) {
+      if (samples < samples_) {
+        return;
+      }
+    }
+
+    std::size_t best = 0;
+    for (std::size_t c = 1; c < entry.candidates.size(); ++c) {
+      if (double(entry.time[c]) / entry.samples[c] <
+          double(entry.time[best]) / entry.samples[best]) {
+        best = c;
+      }
+    }
+    entry.best = best;
+    entry.tuned = true;
+    HPX_KOKKOS_DETAIL_LOG("autotuning chose candidate %zu of %zu", best,
+                          entry.candidates.size());
+  }
+
+  void clear() {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    entries.clear();
+  }
+
+  /// Writes the tuned entries, one per line, as the execution space, rank,
+  /// bucket, parameters, and the label, separated by spaces. The label is
+  /// last since it may contain spaces.
+  void write(std::ostream &os) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    for (auto const &e : entries) {
+      if (!e.second->tuned) {
+        continue;
+      }
+      auto const &p = e.second->candidates[e.second->best];
+      os << e.first.execution_space << ' ' << e.first.rank << ' '
+         << e.first.bucket << ' ' << p.chunks_per_thread << ' '
+         << p.tile_size << ' ' << p.light_weight << ' ' << e.first.label
+         << '\n';
+    }
+  }
+
+  /// Reads entries written by write. Malformed lines are skipped. Read
+  /// entries replace existing entries with the same key.
+  void read(std::istream &is) {
+    std::string line;
+    while (std::getline(is, line)) {
+      std::istringstream ls(line);
+      autotune_key key;
+      launch_parameters p;
+      if (!(ls >> key.execution_space >> key.rank >> key.bucket >>
+            p.chunks_per_thread >> p.tile_size >> p.light_weight) ||
+          ls.get() != ' ' || !std::getline(ls, key.label)) {
+        continue;
+      }
+
+      auto entry = std::make_shared<autotune_entry>();
+      entry->candidates.push_back(p);
+      entry->time.push_back(0);
+      entry->samples.push_back(0);
+      entry->tuned = true;
+
+      std::lock_guard<hpx::spinlock> l(mutex);
+      entries[std::move(key)] = std::move(entry);
+    }
+  }
+
+private:
+  autotuner() = default;
+
+  /// One-dimensional ranges try splitting into one, four, or sixteen chunks
+  /// per thread, or the Kokkos default. Multi-dimensional ranges on the host
+  /// try tiles of 4, 16, or 64 in the last dimension, or the Kokkos default.
+  /// Tiles are left to Kokkos on devices, where their product is limited.
+  /// Both try light- and heavy-weight work items.
+  static std::vector<launch_parameters> candidates(std::size_t rank,
+                                                   bool host) {
+    std::vector<std::size_t> sizes{0};
+    if (rank == 1) {
+      sizes.insert(sizes.end(), {1, 4, 16});
+    } else if (host) {
+      sizes.insert(sizes.end(), {4, 16, 64});
+    }
+
+    std::vector<launch_parameters> c;
+    for (bool const light_weight : {true, false}) {
+      for (auto const size : sizes) {
+        launch_parameters p;
+        p.light_weight = light_weight;
+        (rank == 1 ? p.chunks_per_thread : p.tile_size) = size;
+        c.push_back(p);
+      }
+    }
+    return c;
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<std::size_t> samples_{2};
+  hpx::spinlock mutex;
+  std::map<autotune_key, std::shared_ptr<autotune_entry>> entries;
+};
+
+/// Calls launch with the one-dimensional range policy for [begin, end) on
+/// instance, with tuned parameters if autotuning is enabled, and returns its
+/// future.
+template <typename ExecutionSpace, typename Index, typename Launch>
+auto tuned_range_launch(char const *label, ExecutionSpace const &instance,
+                        Index begin, Index end, Launch &&launch) {
+  using policy_type = Kokkos::RangePolicy<ExecutionSpace>;
+  auto &tuner = autotuner::get();
+  if (!tuner.enabled()) {
+    if constexpr (is_execution_space_synchronous<ExecutionSpace>::value) {
+      // Work item hints have no effect on synchronous host spaces
+      return launch(policy_type(instance, begin, end));
+    } else {
+      return launch(Kokkos::Experimental::require(
+          policy_type(instance, begin, end),
+          Kokkos::Experimental::WorkItemProperty::HintLightWeight));
+    }
+  }
+
+  std::size_t const n = end > begin ? std::size_t(end - begin) : 0;
+  auto const s = tuner.select(label, ExecutionSpace::name(), 1, n, true);
+  policy_type policy(instance, begin, end);
+  if (s.parameters.chunks_per_thread > 0) {
+    std::size_t const chunks =
+        std::size_t((std::max)(instance.concurrency(), 1)) *
+        s.parameters.chunks_per_thread;
+    policy.set_chunk_size(int((std::max)((n + chunks - 1) / chunks,
+                                         std::size_t(1))));
+  }
+
+  auto const start = hpx::chrono::high_resolution_clock::now();
+  auto f = s.parameters.light_weight
+               ? launch(Kokkos::Experimental::require(
+                     policy,
+                     Kokkos::Experimental::WorkItemProperty::HintLightWeight))
+               : launch(Kokkos::Experimental::require(
+                     policy,
+                     Kokkos::Experimental::WorkItemProperty::HintHeavyWeight));
+  if (s.entry) {
+    f.then(hpx::launch::sync, [s, start](auto &&) {
+      autotuner::get().record(
+          s, hpx::chrono::high_resolution_clock::now() - start);
+    });
+  }
+  return f;
+}
+
+/// Calls launch with the multi-dimensional range policy for [first, last) on
+/// instance, with tuned parameters if autotuning is enabled, and returns its
+/// future.
+template <typename ExecutionSpace, typename I, std::size_t N, typename Launch>
+auto tuned_mdrange_launch(char const *label, ExecutionSpace const &instance,
+                          Kokkos::Array<I, N> const &first,
+                          Kokkos::Array<I, N> const &last, Launch &&launch) {
+  using policy_type =
+      Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<N>,
+                            Kokkos::IndexType<I>>;
+  auto &tuner = autotuner::get();
+  if (!tuner.enabled()) {
+    if constexpr (is_execution_space_synchronous<ExecutionSpace>::value) {
+      return launch(policy_type(instance, first, last));
+    } else {
+      return launch(Kokkos::Experimental::require(
+          policy_type(instance, first, last),
+          Kokkos::Experimental::WorkItemProperty::HintLightWeight));
+    }
+  }
+
+  std::size_t n = 1;
+  for (std::size_t i = 0; i < N; ++i) {
+    n *= last[i] > first[i] ? std::size_t(last[i] - first[i]) : 0;
+  }
+  constexpr bool host = Kokkos::SpaceAccessibility<
+      Kokkos::HostSpace, typename ExecutionSpace::memory_space>::accessible;
+  auto const s = tuner.select(label, ExecutionSpace::name(), N, n, host);
+  typename policy_type::tile_type tiles{};
+  tiles[N - 1] = s.parameters.tile_size;
+  policy_type policy(instance, first, last, tiles);
+
+  auto const start = hpx::chrono::high_resolution_clock::now();
+  auto f = s.parameters.light_weight
+               ? launch(Kokkos::Experimental::require(
+                     policy,
+                     Kokkos::Experimental::WorkItemProperty::HintLightWeight))
+               : launch(Kokkos::Experimental::require(
+                     policy,
+                     Kokkos::Experimental::WorkItemProperty::HintHeavyWeight));
+  if (s.entry) {
+    f.then(hpx::launch::sync, [s, start](auto &&) {
+      autotuner::get().record(
+          s, hpx::chrono::high_resolution_clock::now() - start);
+    });
+  }
+  return f;
+}
+} // namespace detail
+
+/// Enables or disables autotuning of the launch parameters of HPX algorithms.
+/// Autotuning is disabled by default, and can also be enabled at startup with
+/// --hpx:ini=hpx.kokkos.autotune=<file>, in which case tuned parameters are
+/// read from file if it exists and written to it at shutdown.
+inline void enable_autotuning(bool enable = true) {
+  detail::autotuner::get().enable(enable);
+}
+
+/// Sets the number of calls each candidate is timed for before the fastest
+/// is chosen. The default is 2, and can also be set at startup with
+/// --hpx:ini=hpx.kokkos.autotune_samples=<samples>.
+inline void set_autotuning_samples(std::size_t samples) {
+  detail::autotuner::get().set_samples(samples);
+}
+
+/// Writes the parameters tuned so far.
+inline void write_autotuning_cache(std::ostream &os) {
+  detail::autotuner::get().write(os);
+}
+
+inline void write_autotuning_cache(std::string const &filename) {
+  std::ofstream os(filename);
+  write_autotuning_cache(os);
+}
+
+/// Reads parameters written by write_autotuning_cache. Calls with keys that
+/// are read use the read parameters without exploring candidates.
+inline void read_autotuning_cache(std::istream &is) {
+  detail::autotuner::get().read(is);
+}
+
+inline void read_autotuning_cache(std::string const &filename) {
+  std::ifstream is(filename);
+  read_autotuning_cache(is);
+}
+
+/// Discards all tuned and partially tuned parameters.
+inline void clear_autotuning() { detail::autotuner::get().clear(); }
+
+namespace detail {
+inline void register_autotuning() {
+  std::string const samples =
+      hpx::get_config_entry("hpx.kokkos.autotune_samples", "");
+  if (!samples.empty()) {
+    set_autotuning_samples(std::stoul(samples));
+  }
+
+  std::string const filename = hpx::get_config_entry("hpx.kokkos.autotune", "");
+  if (!filename.empty()) {
+    read_autotuning_cache(filename);
+    enable_autotuning();
+    hpx::register_shutdown_function(
+        [filename] { write_autotuning_cache(filename); });
+  }
+}
+
+struct autotune_registration {
+  autotune_registration() {
+    hpx::register_pre_startup_function(&register_autotuning);
+  }
+};
+
+inline autotune_registration const autotune_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,274 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains an executor that splits the iteration range of an algorithm
+/// between a host and a device execution space, with a split ratio learned
+/// per label from the completion times of previous calls.
+
+#pragma once
+
+#include <hpx/kokkos/detail/partitioned_launch.hpp>
+#include <hpx/kokkos/executors.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+
+#include <hpx/chrono.hpp>
+#include <hpx/future.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// The fractions of the range given to the host for each label, shared by all
+/// co_executors with the same execution spaces.
+template <typename HostExecutionSpace, typename DeviceExecutionSpace>
+class co_execution_fractions {
+public:
+  static co_execution_fractions &get() {
+    static co_execution_fractions f;
+    return f;
+  }
+
+  /// The smallest fraction of the range given to either side, so that both
+  /// sides keep being measured.
+  static constexpr double min_fraction = 1.0 / 64;
+
+  double host_fraction(std::string const &label, double initial) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    return fractions.emplace(label, initial).first->second;
+  }
+
+  void set_host_fraction(std::string const &label, double fraction) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    fractions[label] = clamp(fraction);
+  }
+
+  /// Moves the fraction of label towards the split at which both sides would
+  /// have taken the same time, given the observed number of elements and
+  /// completion times of each side. Uses an exponential moving average with
+  /// weight 1/4 for new samples.
+  void observe(std::string const &label, std::size_t host_n,
+               std::int64_t host_ns, std::size_t device_n,
+               std::int64_t device_ns) {
+    if (host_n == 0 || device_n == 0) {
+      return;
+    }
+    double const host_rate =
+        double(host_n) / double((std::max)(host_ns, std::int64_t(1)));
+    double const device_rate =
+        double(device_n) / double((std::max)(device_ns, std::int64_t(1)));
+    double const target = host_rate / (host_rate + device_rate);
+
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto it = fractions.find(label);
+    if (it != fractions.end()) {
+      it->second = clamp(it->second + (target - it->second) / 4);
+    }
+  }
+
+private:
+  static double clamp(double f) {
+    return (std::min)((std::max)(f, min_fraction), 1 - min_fraction);
+  }
+
+  hpx::spinlock mutex;
+  std::map<std::string, double> fractions;
+};
+} // namespace detail
+
+/// \brief HPX executor splitting one-dimensional iteration ranges between a
+/// host executor and a device executor.
+///
+/// The ranges of hpx::for_each, hpx::experimental::for_loop, hpx::reduce, and
+/// hpx::transform are split into a block at the start of the range for the
+/// host and a block at the end for the device. The fraction of the range
+/// given to the host is learned per label (see kokkos_policy::label) from
+/// the completion times of previous calls, so that both sides finish at the
+/// same time. The algorithms return a single future for both blocks. The data
+/// accessed by the algorithm must be accessible from both execution spaces.
+/// Multi-dimensional ranges and other launches use the device executor.
+template <typename HostExecutionSpace = Kokkos::DefaultHostExecutionSpace,
+          typename DeviceExecutionSpace = Kokkos::DefaultExecutionSpace>
+class co_executor {
+public:
+  using host_execution_space = HostExecutionSpace;
+  using device_execution_space = DeviceExecutionSpace;
+  using execution_space = DeviceExecutionSpace;
+  using execution_category = hpx::execution::parallel_execution_tag;
+
+  /// Creates an executor splitting ranges between host and device. Labels
+  /// without previous calls give initial_host_fraction of the range to host.
+  explicit co_executor(
+      executor<host_execution_space> host = executor<host_execution_space>{},
+      executor<device_execution_space> device =
+          executor<device_execution_space>{},
+      double initial_host_fraction = 0.5)
+      : host_(std::move(host)), device_(std::move(device)),
+        initial_host_fraction_(initial_host_fraction) {}
+
+  executor<host_execution_space> const &host_executor() const {
+    return host_;
+  }
+  executor<device_execution_space> const &device_executor() const {
+    return device_;
+  }
+
+  execution_space instance() const { return device_.instance(); }
+
+  /// Returns the fraction of the range of calls labeled label given to the
+  /// host.
+  double host_fraction(std::string const &label) const {
+    return fractions().host_fraction(label, initial_host_fraction_);
+  }
+  /// Sets the fraction of the range of calls labeled label given to the host.
+  /// The fraction keeps being adapted by later calls.
+  void set_host_fraction(std::string const &label, double fraction) const {
+    fractions().set_host_fraction(label, fraction);
+  }
+
+  co_executor with_future_strategy(future_strategy s) const {
+    auto exec = *this;
+    exec.host_ = host_.with_future_strategy(s);
+    exec.device_ = device_.with_future_strategy(s);
+    return exec;
+  }
+  future_strategy strategy() const { return device_.strategy(); }
+
+  template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    device_.post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  template <typename F, typename... Ts>
+  hpx::shared_future<void> async_execute(F &&f, Ts &&...ts) {
+    return device_.async_execute(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  /// Returns a future that becomes ready when all work submitted to the host
+  /// and device instances so far has completed.
+  hpx::shared_future<void> get_future() {
+    return detail::combine_futures({host_.get_future(), device_.get_future()});
+  }
+
+  template <typename Parameters, typename F>
+  constexpr std::size_t get_chunk_size(Parameters &&params, F &&f,
+                                       std::size_t cores,
+                                       std::size_t count) const {
+    return std::size_t(-1);
+  }
+
+  static detail::co_execution_fractions<host_execution_space,
+                                        device_execution_space> &
+  fractions() {
+    return detail::co_execution_fractions<host_execution_space,
+                                          device_execution_space>::get();
+  }
+
+private:
+  executor<host_execution_space> host_;
+  executor<device_execution_space> device_;
+  double initial_host_fraction_ = 0.5;
+};
+
+template <typename HostExecutionSpace, typename DeviceExecutionSpace>
+struct is_kokkos_executor<co_executor<HostExecutionSpace, DeviceExecutionSpace>>
+    : std::true_type {};
+
+namespace detail {
+template <typename HostExecutionSpace, typename DeviceExecutionSpace>
+struct partitioned_launch<
+    co_executor<HostExecutionSpace, DeviceExecutionSpace>> {
+  using executor_type = co_executor<HostExecutionSpace, DeviceExecutionSpace>;
+
+  /// The completion times of the two blocks of one call.
+  struct sample {
+    std::string label;
+    std::size_t host_n = 0;
+    std::size_t device_n = 0;
+    std::int64_t host_ns = 0;
+    std::int64_t device_ns = 0;
+    std::atomic<int> remaining{2};
+
+    void complete() {
+      if (--remaining == 0) {
+        executor_type::fractions().observe(label, host_n, host_ns, device_n,
+                                           device_ns);
+      }
+    }
+  };
+
+  template <typename I, typename Launch>
+  static auto call(executor_type const &exec, char const *label, I first,
+                   I last, Launch &&launch) {
+    using future_type =
+        decltype(launch(exec.device_executor().instance(), first, last));
+
+    auto const n = static_cast<std::size_t>(last - first);
+    auto const host_n = static_cast<std::size_t>(
+        std::lround(n * exec.host_fraction(label)));
+    I const split = I(first + host_n);
+
+    auto s = std::make_shared<sample>();
+    s->label = label;
+    s->host_n = host_n;
+    s->device_n = n - host_n;
+
+    // The device block is launched first since launches on host execution
+    // spaces may block until the work is done. Each block is timed from its
+    // own launch.
+    auto const device_start = hpx::chrono::high_resolution_clock::now();
+    future_type device_future =
+        launch(exec.device_executor().instance(), split, last);
+    device_future.then(hpx::launch::sync, [s, device_start](auto &&) {
+      s->device_ns = static_cast<std::int64_t>(
+          hpx::chrono::high_resolution_clock::now() - device_start);
+      s->complete();
+    });
+
+    auto const host_start = hpx::chrono::high_resolution_clock::now();
+    future_type host_future =
+        launch(exec.host_executor().instance(), first, split);
+    host_future.then(hpx::launch::sync, [s, host_start](auto &&) {
+      s->host_ns = static_cast<std::int64_t>(
+          hpx::chrono::high_resolution_clock::now() - host_start);
+      s->complete();
+    });
+
+    std::vector<future_type> futures;
+    futures.reserve(2);
+    futures.push_back(std::move(host_future));
+    futures.push_back(std::move(device_future));
+    return futures;
+  }
+};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
+
+namespace HPXKOKKOS_HPX_EXECUTOR_NS {
+template <typename HostExecutionSpace, typename DeviceExecutionSpace>
+struct is_one_way_executor<
+    hpx::kokkos::co_executor<HostExecutionSpace, DeviceExecutionSpace>>
+    : std::true_type {};
+
+template <typename HostExecutionSpace, typename DeviceExecutionSpace>
+struct is_two_way_executor<
+    hpx::kokkos::co_executor<HostExecutionSpace, DeviceExecutionSpace>>
+    : std::true_type {};
+} // namespace HPXKOKKOS_HPX_EXECUTOR_NS
@@ -0,0 +1,130 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains awaiters for using futures returned by this library, execution
+/// space instances, and executors in C++20 coroutines. Only available when the
+/// compiler supports coroutines, in which case HPX_KOKKOS_HAVE_COROUTINES is
+/// defined.
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define HPX_KOKKOS_HAVE_COROUTINES
+
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/thread_pool_binding.hpp>
+#include <hpx/kokkos/executors.hpp>
+#include <hpx/kokkos/future.hpp>
+
+#include <hpx/execution.hpp>
+#include <hpx/future.hpp>
+#include <hpx/modules/threading_base.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Resumes h on an HPX worker, on the pool of binding if it is not null. The
+/// coroutine is resumed directly if the calling thread already is such a
+/// worker, and from a new HPX thread otherwise, e.g. when called from a CUDA
+/// callback thread.
+inline void resume_on_worker(std::coroutine_handle<> h,
+                             thread_pool_binding const *binding) {
+  bool const on_worker = binding == nullptr
+                             ? hpx::threads::get_self_ptr() != nullptr
+                             : binding->contains_current_thread();
+  if (on_worker) {
+    h.resume();
+    return;
+  }
+
+  HPX_KOKKOS_DETAIL_LOG_FUTURE("resuming coroutine on a new HPX thread");
+  hpx::parallel::execution::post(
+      binding == nullptr ? hpx::execution::parallel_executor()
+                         : binding->executor(),
+      [h] { h.resume(); });
+}
+
+/// Awaits a future. If the future is ready the coroutine continues inline.
+/// Otherwise a completion callback is attached directly to the shared state
+/// of the future, instead of creating a continuation with its own shared
+/// state, and the callback resumes the coroutine on an HPX worker. If the
+/// future becomes ready while the callback is being attached, the callback
+/// runs within await_suspend. It then leaves the coroutine to continue inline
+/// instead of resuming it from within await_suspend.
+class future_awaiter {
+public:
+  explicit future_awaiter(hpx::shared_future<void> f,
+                          thread_pool_binding const *binding = nullptr)
+      : f(std::move(f)), binding(binding) {}
+
+  // Awaiters are only moved before they are awaited
+  future_awaiter(future_awaiter &&other) noexcept
+      : f(std::move(other.f)), binding(other.binding) {}
+
+  bool await_ready() const noexcept { return f.is_ready(); }
+
+  bool await_suspend(std::coroutine_handle<> h) {
+    if (f.is_ready()) {
+      return false;
+    }
+
+    // Whichever of await_suspend and the callback finishes second decides:
+    // the callback resumes the coroutine, or await_suspend continues it
+    hpx::traits::detail::get_shared_state(f)->set_on_completed([this, h] {
+      if (attached.exchange(true, std::memory_order_acq_rel)) {
+        resume_on_worker(h, binding);
+      }
+    });
+    return !attached.exchange(true, std::memory_order_acq_rel);
+  }
+
+  void await_resume() const { f.get(); }
+
+private:
+  hpx::shared_future<void> f;
+  thread_pool_binding const *binding;
+  std::atomic<bool> attached{false};
+};
+} // namespace detail
+
+/// Returns an awaiter for f, e.g. the future returned by parallel_for_async or
+/// deep_copy_async. co_await on it rethrows the exception of f, if any.
+inline detail::future_awaiter awaitable(hpx::shared_future<void> f) {
+  return detail::future_awaiter(std::move(f));
+}
+
+inline detail::future_awaiter awaitable(hpx::future<void> &&f) {
+  return detail::future_awaiter(f.share());
+}
+
+/// Returns an awaiter for all work currently submitted to inst. The coroutine
+/// is resumed on the thread pool inst is bound to, if any.
+template <typename ExecutionSpace,
+          typename Enable = typename std::enable_if<Kokkos::is_execution_space<
+              typename std::decay<ExecutionSpace>::type>::value>::type>
+detail::future_awaiter awaitable(ExecutionSpace const &inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  return detail::future_awaiter(detail::get_future<execution_space>::call(inst),
+                                detail::find_thread_pool_binding(inst));
+}
+
+/// Awaits all work currently submitted to the instance of exec, completing
+/// its future with the strategy of exec.
+template <typename ExecutionSpace>
+detail::future_awaiter operator co_await(executor<ExecutionSpace> exec) {
+  return detail::future_awaiter(
+      exec.get_future(), detail::find_thread_pool_binding(exec.instance()));
+}
+} // namespace kokkos
+} // namespace hpx
+#endif
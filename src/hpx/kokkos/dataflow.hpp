@@ -0,0 +1,212 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains a dataflow helper that launches work on an execution space
+/// instance directly from the completion of its last dependency, without an
+/// HPX thread being created to launch it.
+
+#pragma once
+
+#include <hpx/kokkos/detail/future_origin.hpp>
+#include <hpx/kokkos/detail/graph_capture.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+
+#include <hpx/functional.hpp>
+#include <hpx/future.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Calls visit with f if it is a future, or with each future in f if it is a
+/// range of futures.
+template <typename Dependency, typename F>
+void for_each_dataflow_future(Dependency const &dep, F &&visit) {
+  if constexpr (hpx::traits::is_future<Dependency>::value) {
+    visit(dep);
+  } else {
+    static_assert(hpx::traits::is_future_range<Dependency>::value,
+                  "dependencies of hpx::kokkos::dataflow must be futures or "
+                  "ranges of futures");
+    for (auto const &f : dep) {
+      visit(f);
+    }
+  }
+}
+
+/// Whether work on inst can be launched without waiting for f. This is the
+/// case if f is ready without an exception, or if it was produced on the same
+/// in-order instance as inst.
+template <typename ExecutionSpace, typename Future>
+bool dataflow_satisfied(ExecutionSpace const &inst, Future const &f) {
+  if (f.is_ready()) {
+    return !f.has_exception();
+  }
+  if constexpr (std::is_same<Future, hpx::shared_future<void>>::value) {
+    return produced_on(inst, f);
+  } else {
+    return false;
+  }
+}
+
+/// Holds everything needed to launch a kernel once its dependencies are ready,
+/// in a single allocation. A completion callback is attached directly to each
+/// dependency that is not yet satisfied. The callbacks only hold a pointer to
+/// the frame, so they fit in the small buffer of the callback and no further
+/// allocation is made per dependency. The last callback to run launches the
+/// kernel, and the frame deletes itself once the work of the kernel has
+/// completed.
+template <typename ExecutionSpace, typename Kernel, typename... Dependencies>
+class dataflow_frame {
+public:
+  template <typename K, typename... Ds>
+  dataflow_frame(ExecutionSpace const &inst, K &&kernel, Ds &&...deps)
+      : inst(inst), kernel(std::forward<K>(kernel)),
+        dependencies(std::forward<Ds>(deps)...) {}
+
+  hpx::shared_future<void> start() {
+    // The frame may be deleted by the callbacks as soon as the hold of start
+    // is released
+    hpx::shared_future<void> f = promise.get_future();
+    std::apply([this](auto const &...deps) { (wait_for(deps), ...); },
+               dependencies);
+    dependency_ready();
+    return f;
+  }
+
+private:
+  template <typename Dependency> void wait_for(Dependency const &dep) {
+    for_each_dataflow_future(dep, [this](auto const &f) {
+      if (!dataflow_satisfied(inst, f)) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        hpx::traits::detail::get_shared_state(f)->set_on_completed(
+            [this] { dependency_ready(); });
+      }
+    });
+  }
+
+  void dependency_ready() {
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      launch();
+    }
+  }
+
+  /// Returns the exception of the first dependency that has one.
+  std::exception_ptr dependency_exception() const {
+    std::exception_ptr e;
+    std::apply(
+        [&e](auto const &...deps) {
+          (for_each_dataflow_future(deps,
+                                    [&e](auto const &f) {
+                                      if (!e && f.is_ready() &&
+                                          f.has_exception()) {
+                                        e = f.get_exception_ptr();
+                                      }
+                                    }),
+           ...);
+        },
+        dependencies);
+    return e;
+  }
+
+  void launch() {
+    std::exception_ptr e = dependency_exception();
+    if (!e) {
+      HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(
+          "launching dataflow kernel from completion of last dependency");
+      try {
+        result = hpx::shared_future<void>(hpx::invoke(kernel, inst));
+      } catch (...) {
+        e = std::current_exception();
+      }
+    }
+
+    if (e) {
+      promise.set_exception(e);
+      delete this;
+      return;
+    }
+
+    // The frame is not touched after this since complete may have deleted it
+    hpx::traits::detail::get_shared_state(result)->set_on_completed(
+        [this] { complete(); });
+  }
+
+  void complete() {
+    if (result.has_exception()) {
+      promise.set_exception(result.get_exception_ptr());
+    } else {
+      promise.set_value();
+    }
+    delete this;
+  }
+
+  std::atomic<std::size_t> pending{1};
+  ExecutionSpace inst;
+  Kernel kernel;
+  std::tuple<Dependencies...> dependencies;
+  hpx::shared_future<void> result;
+  hpx::promise<void> promise;
+};
+} // namespace detail
+
+/// Launches work on inst once all deps are ready and returns a future that is
+/// ready once that work has completed. kernel is called with inst, and has to
+/// enqueue the work on it and return a future to it, e.g. the future returned
+/// by parallel_for_async. deps can be futures of any type, or ranges of
+/// futures. Their values are ignored, and if any of them has an exception the
+/// kernel is not called and the exception is propagated to the returned
+/// future.
+///
+/// Unlike hpx::dataflow, no HPX thread is created to call the kernel. It is
+/// called directly by whoever makes the last dependency ready. Dependencies
+/// that are ready, or that were produced on the same in-order instance as
+/// inst, are not waited for. If no dependency has to be waited for, the kernel
+/// is called immediately and its future is returned as is.
+template <
+    typename ExecutionSpace, typename Kernel, typename... Dependencies,
+    typename Enable = typename std::enable_if<Kokkos::is_execution_space<
+        typename std::decay<ExecutionSpace>::type>::value>::type>
+hpx::shared_future<void> dataflow(ExecutionSpace &&inst, Kernel &&kernel,
+                                  Dependencies &&...deps) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+
+  bool satisfied = true;
+  int const sequencer[] = {
+      0, (detail::for_each_dataflow_future(
+              deps,
+              [&](auto const &f) {
+                satisfied = satisfied && detail::dataflow_satisfied(inst, f);
+              }),
+          0)...};
+  (void)sequencer;
+
+  // While capturing a graph launches are recorded in order on the same
+  // instance, and are replayed in that order
+  if (satisfied || detail::graph_capture<execution_space>::capturing(inst)) {
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(
+        "launching dataflow kernel immediately, dependencies are satisfied");
+    return hpx::shared_future<void>(
+        hpx::invoke(std::forward<Kernel>(kernel), inst));
+  }
+
+  using frame_type =
+      detail::dataflow_frame<execution_space, typename std::decay<Kernel>::type,
+                             typename std::decay<Dependencies>::type...>;
+  return (new frame_type(inst, std::forward<Kernel>(kernel),
+                         std::forward<Dependencies>(deps)...))
+      ->start();
+}
+} // namespace kokkos
+} // namespace hpx
@@ -9,21 +9,177 @@
 
 #pragma once
 
+#include <hpx/kokkos/dependencies.hpp>
+#include <hpx/kokkos/detail/dispatch.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
 #include <hpx/kokkos/future.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace hpx {
 namespace kokkos {
+namespace detail {
+struct deep_copy_fn {
+  template <typename... Args> void operator()(Args &&...args) const {
+    Kokkos::deep_copy(std::forward<Args>(args)...);
+  }
+};
+} // namespace detail
+
 // TODO: Do we need more overloads here?
 template <typename ExecutionSpace, typename... Args,
           typename Enable = typename std::enable_if<Kokkos::is_execution_space<
               typename std::decay<ExecutionSpace>::type>::value>::type>
 hpx::shared_future<void> deep_copy_async(ExecutionSpace &&space,
                                          Args &&...args) {
-  Kokkos::deep_copy(space, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<ExecutionSpace>::type>::call(
-      std::forward<ExecutionSpace>(space));
+  return detail::dispatch(space, "deep_copy", detail::deep_copy_fn{}, space,
+                          std::forward<Args>(args)...);
+}
+
+/// deep_copy_async overload that starts the copy once the given dependencies
+/// are ready. The dependencies are waited for without blocking an HPX thread.
+template <typename Dependencies, typename ExecutionSpace, typename... Args,
+          typename Enable = typename std::enable_if<
+              is_dependency<typename std::decay<Dependencies>::type>::value &&
+              Kokkos::is_execution_space<
+                  typename std::decay<ExecutionSpace>::type>::value>::type>
+hpx::shared_future<void> deep_copy_async(Dependencies &&deps,
+                                         ExecutionSpace &&space,
+                                         Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH("calling deep_copy_async with dependencies");
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  execution_space inst(std::forward<ExecutionSpace>(space));
+  return detail::launch_after(
+      inst, std::forward<Dependencies>(deps),
+      [inst,
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return deep_copy_async(execution_space(inst), captured...);
+            },
+            pack);
+      });
+}
+
+namespace detail {
+// Views are chunked along their slowest-varying dimension so that each chunk
+// is contiguous for contiguous views: the first dimension for LayoutRight (and
+// rank 1 views), the last dimension for LayoutLeft.
+template <typename View>
+struct chunk_dimension
+    : std::integral_constant<
+          std::size_t,
+          (std::is_same<typename View::array_layout, Kokkos::LayoutLeft>::value &&
+           View::rank > 1)
+              ? View::rank - 1
+              : 0> {};
+
+template <typename View, std::size_t... Is>
+auto chunk_subview_helper(std::integral_constant<bool, false>, View const &v,
+                          Kokkos::pair<std::size_t, std::size_t> r,
+                          std::index_sequence<Is...>) {
+  return Kokkos::subview(v, r, ((void)Is, Kokkos::ALL)...);
+}
+
+template <typename View, std::size_t... Is>
+auto chunk_subview_helper(std::integral_constant<bool, true>, View const &v,
+                          Kokkos::pair<std::size_t, std::size_t> r,
+                          std::index_sequence<Is...>) {
+  return Kokkos::subview(v, ((void)Is, Kokkos::ALL)..., r);
+}
+
+inline Kokkos::pair<std::size_t, std::size_t>
+chunk_bounds(std::size_t const extent, std::size_t const num_chunks,
+             std::size_t const chunk) {
+  return {extent * chunk / num_chunks, extent * (chunk + 1) / num_chunks};
+}
+
+inline std::size_t effective_num_chunks(std::size_t const extent,
+                                        std::size_t const num_chunks) {
+  return (std::max)(std::size_t(1), (std::min)(extent, num_chunks));
+}
+} // namespace detail
+
+/// Returns the part of the view v that is copied by chunk number chunk when
+/// calling deep_copy_async_chunked with num_chunks chunks. Consumers can use
+/// this to launch work on a chunk as soon as its future is ready.
+template <typename View>
+auto view_chunk(View const &v, std::size_t const num_chunks,
+                std::size_t const chunk) {
+  static_assert(View::rank > 0, "view_chunk requires views of rank > 0");
+  constexpr std::size_t dim = detail::chunk_dimension<View>::value;
+  std::size_t const extent = v.extent(dim);
+  return detail::chunk_subview_helper(
+      std::integral_constant<bool, (dim > 0)>{}, v,
+      detail::chunk_bounds(extent,
+                           detail::effective_num_chunks(extent, num_chunks),
+                           chunk),
+      std::make_index_sequence<View::rank - 1>{});
+}
+
+/// Asynchronously copies src to dst in num_chunks slices, distributing the
+/// slices round-robin over the given execution space instances. Returns one
+/// future per slice, in order. The slices are those returned by view_chunk.
+/// If the extent of the chunked dimension is smaller than num_chunks, fewer
+/// chunks are used.
+template <typename ExecutionSpace, typename Dst, typename Src>
+std::vector<hpx::shared_future<void>>
+deep_copy_async_chunked(std::vector<ExecutionSpace> const &instances,
+                        Dst const &dst, Src const &src,
+                        std::size_t const num_chunks) {
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value,
+                "deep_copy_async_chunked requires Kokkos execution spaces");
+  static_assert(unsigned(Dst::rank) == unsigned(Src::rank),
+                "deep_copy_async_chunked requires views of equal rank");
+  static_assert(
+      std::is_same<typename Dst::array_layout,
+                   typename Src::array_layout>::value,
+      "deep_copy_async_chunked requires the same layout for src and dst");
+
+  if (instances.empty()) {
+    throw std::runtime_error(
+        "deep_copy_async_chunked: at least one instance is required");
+  }
+
+  constexpr std::size_t dim = detail::chunk_dimension<Dst>::value;
+  if (dst.extent(dim) != src.extent(dim)) {
+    throw std::runtime_error("deep_copy_async_chunked: Error, extent mismatch "
+                             "between source and target views");
+  }
+
+  std::size_t const chunks =
+      detail::effective_num_chunks(dst.extent(dim), num_chunks);
+  std::vector<hpx::shared_future<void>> futures;
+  futures.reserve(chunks);
+  for (std::size_t c = 0; c < chunks; ++c) {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("deep_copy_async_chunked chunk %zu/%zu", c,
+                                 chunks);
+    futures.push_back(deep_copy_async(instances[c % instances.size()],
+                                      view_chunk(dst, chunks, c),
+                                      view_chunk(src, chunks, c)));
+  }
+  return futures;
+}
+
+/// Asynchronously copies src to dst in num_chunks slices on a single
+/// execution space instance. The slices are enqueued in order, and the future
+/// for a slice becomes ready as soon as that slice has been copied.
+template <typename ExecutionSpace, typename Dst, typename Src,
+          typename Enable = typename std::enable_if<Kokkos::is_execution_space<
+              typename std::decay<ExecutionSpace>::type>::value>::type>
+std::vector<hpx::shared_future<void>>
+deep_copy_async_chunked(ExecutionSpace &&space, Dst const &dst, Src const &src,
+                        std::size_t const num_chunks) {
+  return deep_copy_async_chunked(
+      std::vector<typename std::decay<ExecutionSpace>::type>{
+          std::forward<ExecutionSpace>(space)},
+      dst, src, num_chunks);
 }
 #if defined(KOKKOS_ENABLE_SYCL)
 #if !defined(HPX_KOKKOS_SYCL_FUTURE_TYPE)
@@ -97,13 +253,22 @@ hpx::shared_future<void> deep_copy_async(Kokkos::Experimental::SYCL &&instance,
   auto event = q.memcpy(t.data(), s.data(), t.size() *
       sizeof(typename std::decay<TargetSpace>::type::data_type));
   // Use event from memcpy to get a future
-#if HPX_KOKKOS_SYCL_FUTURE_TYPE == 0 
-  return hpx::sycl::experimental::detail::get_future(event);
-#elif HPX_KOKKOS_SYCL_FUTURE_TYPE == 1
-  return hpx::sycl::experimental::detail::get_future_using_host_task(event, q);
-#else
-#error "HPX_KOKKOS_SYCL_FUTURE_TYPE is invalid (must be host_task or event)"
-#endif
+  bool adaptive = false;
+  auto const strategy =
+      detail::resolve_sycl_future_strategy(future_strategy::unspecified,
+                                           adaptive);
+  hpx::shared_future<void> f;
+  if (strategy == future_strategy::event) {
+    f = detail::polled(hpx::sycl::experimental::detail::get_future(event));
+  } else if (strategy == future_strategy::host_task) {
+    f = hpx::sycl::experimental::detail::get_future_using_host_task(event, q);
+  } else {
+    f = detail::fence_on_hpx_thread(instance);
+  }
+  if (adaptive) {
+    detail::adaptive_future_statistics<Kokkos::Experimental::SYCL>::observe(f);
+  }
+  return detail::record_origin(instance, f);
 }
 #endif
 } // namespace kokkos
@@ -0,0 +1,204 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains utilities for launching work on an execution space instance after
+/// a set of dependencies are ready, without blocking an HPX thread.
+
+#pragma once
+
+#include <hpx/kokkos/detail/future_origin.hpp>
+#include <hpx/kokkos/detail/graph_capture.hpp>
+#include <hpx/kokkos/detail/instance_wait.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/future.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+
+#include <hpx/future.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// A dependency on all work submitted to an execution space instance at the
+/// time the dependency is used in a launch. Where the backend supports it, the
+/// dependency is handled by the backend (CUDA and HIP events, SYCL barriers,
+/// or chaining the senders of HPX instances) instead of on the host. Note that
+/// this makes all later work on the waiting instance wait as well.
+template <typename ExecutionSpace> struct instance_dependency {
+  ExecutionSpace instance;
+};
+
+/// Creates a dependency on all work currently submitted to inst.
+template <typename ExecutionSpace>
+instance_dependency<typename std::decay<ExecutionSpace>::type>
+after(ExecutionSpace &&inst) {
+  static_assert(Kokkos::is_execution_space<
+                    typename std::decay<ExecutionSpace>::type>::value,
+                "hpx::kokkos::after requires a Kokkos execution space instance");
+  return {std::forward<ExecutionSpace>(inst)};
+}
+
+/// Trait for types that can be passed as dependencies to the asynchronous
+/// functions in this library.
+template <typename T> struct is_dependency : std::false_type {};
+
+template <> struct is_dependency<hpx::shared_future<void>> : std::true_type {};
+
+template <> struct is_dependency<hpx::future<void>> : std::true_type {};
+
+template <>
+struct is_dependency<std::vector<hpx::shared_future<void>>> : std::true_type {
+};
+
+template <typename ExecutionSpace>
+struct is_dependency<instance_dependency<ExecutionSpace>> : std::true_type {};
+
+/// A tuple of dependencies can be used to combine dependencies of different
+/// types.
+template <typename... Ts>
+struct is_dependency<std::tuple<Ts...>>
+    : std::conjunction<is_dependency<typename std::decay<Ts>::type>...> {};
+
+namespace detail {
+// Adds the dependencies to futures that have to be waited for on the host, or
+// makes inst wait for them directly.
+template <typename T> struct dependency_traits;
+
+template <> struct dependency_traits<hpx::shared_future<void>> {
+  template <typename ExecutionSpace>
+  static void append(ExecutionSpace const &,
+                     std::vector<hpx::shared_future<void>> &futures,
+                     hpx::shared_future<void> const &f) {
+    futures.push_back(f);
+  }
+};
+
+template <> struct dependency_traits<hpx::future<void>> {
+  template <typename ExecutionSpace>
+  static void append(ExecutionSpace const &,
+                     std::vector<hpx::shared_future<void>> &futures,
+                     hpx::future<void> &&f) {
+    futures.emplace_back(std::move(f));
+  }
+};
+
+template <> struct dependency_traits<std::vector<hpx::shared_future<void>>> {
+  template <typename ExecutionSpace>
+  static void append(ExecutionSpace const &,
+                     std::vector<hpx::shared_future<void>> &futures,
+                     std::vector<hpx::shared_future<void>> const &fs) {
+    futures.insert(futures.end(), fs.begin(), fs.end());
+  }
+};
+
+template <typename Producer>
+struct dependency_traits<instance_dependency<Producer>> {
+  template <typename ExecutionSpace>
+  static void append(ExecutionSpace const &inst,
+                     std::vector<hpx::shared_future<void>> &futures,
+                     instance_dependency<Producer> const &dep) {
+    instance_wait<ExecutionSpace, Producer>::call(inst, dep.instance, futures);
+  }
+};
+
+template <typename... Ts> struct dependency_traits<std::tuple<Ts...>> {
+  template <typename ExecutionSpace, typename Tuple, std::size_t... Is>
+  static void append_helper(ExecutionSpace const &inst,
+                            std::vector<hpx::shared_future<void>> &futures,
+                            Tuple &&deps, std::index_sequence<Is...>) {
+    int const sequencer[] = {
+        0, (dependency_traits<typename std::decay<Ts>::type>::append(
+                inst, futures, std::get<Is>(std::forward<Tuple>(deps))),
+            0)...};
+    (void)sequencer;
+  }
+
+  template <typename ExecutionSpace, typename Tuple>
+  static void append(ExecutionSpace const &inst,
+                     std::vector<hpx::shared_future<void>> &futures,
+                     Tuple &&deps) {
+    append_helper(inst, futures, std::forward<Tuple>(deps),
+                  std::index_sequence_for<Ts...>{});
+  }
+};
+
+// Arguments to deferred launches are copied, except for non-const lvalue
+// references to non-class types. Those are the scalar result arguments of
+// parallel_reduce and parallel_scan, which must refer to the caller's
+// variable. As for the non-deferred functions, the caller has to keep them
+// alive until the returned future is ready.
+template <typename T>
+using capture_t = typename std::conditional<
+    std::is_lvalue_reference<T>::value &&
+        !std::is_const<typename std::remove_reference<T>::type>::value &&
+        !std::is_class<typename std::remove_reference<T>::type>::value,
+    T, typename std::decay<T>::type>::type;
+
+template <typename... Args>
+std::tuple<capture_t<Args>...> capture_args(Args &&...args) {
+  return std::tuple<capture_t<Args>...>(std::forward<Args>(args)...);
+}
+
+/// Calls launch, which enqueues work on inst and returns a future to it, once
+/// all the dependencies are ready. Ready dependencies are skipped, as are
+/// dependencies produced on the same in-order instance as inst since the work
+/// will anyway be ordered after them. Remaining dependencies are waited for
+/// with a synchronous continuation, i.e. the work is enqueued directly by
+/// whoever makes the last dependency ready and no HPX thread is blocked waiting
+/// for the dependencies. The deferred launch uses the scoped future strategy of
+/// the calling thread, not the one of the thread making the dependency ready.
+template <typename ExecutionSpace, typename Dependencies, typename F>
+hpx::shared_future<void> launch_after(ExecutionSpace const &inst,
+                                      Dependencies &&deps, F &&launch) {
+  // While capturing a graph launches are recorded in order on the same
+  // instance, and are replayed in that order
+  if (graph_capture<ExecutionSpace>::capturing(inst)) {
+    return launch();
+  }
+
+  std::vector<hpx::shared_future<void>> futures;
+  dependency_traits<typename std::decay<Dependencies>::type>::append(
+      inst, futures, std::forward<Dependencies>(deps));
+
+  futures.erase(std::remove_if(futures.begin(), futures.end(),
+                               [&inst](hpx::shared_future<void> const &f) {
+                                 return f.is_ready() ? !f.has_exception()
+                                                     : produced_on(inst, f);
+                               }),
+                futures.end());
+
+  if (futures.empty()) {
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(
+        "launching immediately, dependencies are ready");
+    return launch();
+  }
+
+  HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(
+      "deferring launch until %zu dependencies are ready", futures.size());
+  auto deferred = with_scoped_future_strategy(std::forward<F>(launch));
+  return hpx::shared_future<void>(
+      hpx::when_all(std::move(futures))
+          .then(hpx::launch::sync,
+                [launch = std::move(deferred)](
+                    hpx::future<std::vector<hpx::shared_future<void>>>
+                        &&f) mutable -> hpx::shared_future<void> {
+                  // Propagate exceptions from dependencies
+                  for (auto &dep : f.get()) {
+                    dep.get();
+                  }
+                  return launch();
+                }));
+}
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,78 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains the common launch path of the asynchronous functions in this
+/// library.
+
+#pragma once
+
+#include <hpx/kokkos/dependencies.hpp>
+#include <hpx/kokkos/detail/graph_capture.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/thread_pool_binding.hpp>
+#include <hpx/kokkos/future.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/instrumentation.hpp>
+
+#include <hpx/future.hpp>
+
+#include <tuple>
+#include <utility>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Calls f with args to submit work to inst and returns a future for the
+/// work, completed using strategy if given. The launch is instrumented under
+/// label. If a graph is capturing on inst, f and copies of args are recorded
+/// in the graph instead and a ready future is returned. If inst is bound to a
+/// thread pool, f is called on the pool and range policies in args are
+/// limited to the concurrency of inst.
+template <typename ExecutionSpace, typename F, typename... Args>
+hpx::shared_future<void>
+dispatch_with_strategy(ExecutionSpace const &inst, future_strategy strategy,
+                       char const *label, F &&f, Args &&...args) {
+  if (auto *c = graph_capture<ExecutionSpace>::capturing(inst)) {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("recording launch in graph");
+    c->nodes.emplace_back(
+        [f = std::forward<F>(f),
+         pack = capture_args(
+             bind_argument(inst, std::forward<Args>(args))...)]() mutable {
+          std::apply(f, pack);
+        });
+    return hpx::make_ready_future();
+  }
+
+  // The strategy is resolved on the calling thread since a scoped strategy
+  // does not apply on the thread pool of a bound instance
+  strategy = resolve_future_strategy(strategy);
+  auto launch = [&] {
+    return instrumented(inst, label, [&] {
+      std::forward<F>(f)(bind_argument(inst, std::forward<Args>(args))...);
+      return get_future<ExecutionSpace>::call(inst, strategy);
+    });
+  };
+
+  auto const *binding = find_thread_pool_binding(inst);
+  if (binding == nullptr || binding->contains_current_thread()) {
+    return launch();
+  }
+
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH("submitting launch from bound thread pool");
+  return binding->submit(launch);
+}
+
+/// Calls dispatch_with_strategy with the strategy of the calling thread.
+template <typename ExecutionSpace, typename F, typename... Args>
+hpx::shared_future<void> dispatch(ExecutionSpace const &inst,
+                                  char const *label, F &&f, Args &&...args) {
+  return dispatch_with_strategy(inst, future_strategy::unspecified, label,
+                                std::forward<F>(f),
+                                std::forward<Args>(args)...);
+}
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
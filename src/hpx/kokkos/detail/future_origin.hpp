@@ -0,0 +1,186 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Keeps track of the execution space instances that futures returned by this
+/// library were produced on. This allows launches with a dependency on a
+/// future from the same in-order instance to be enqueued directly, instead of
+/// waiting for the future on the host.
+
+#pragma once
+
+#include <hpx/kokkos/execution_spaces.hpp>
+
+#include <hpx/future.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Returns a key identifying the queue of an in-order execution space
+/// instance. Copies of an instance have the same key.
+template <typename ExecutionSpace> struct instance_key;
+
+#if defined(KOKKOS_ENABLE_CUDA)
+template <> struct instance_key<Kokkos::Cuda> {
+  static std::uintptr_t call(Kokkos::Cuda const &inst) {
+    return reinterpret_cast<std::uintptr_t>(inst.cuda_stream());
+  }
+};
+#endif
+
+#if defined(KOKKOS_ENABLE_HIP)
+template <> struct instance_key<Kokkos::Experimental::HIP> {
+  static std::uintptr_t call(Kokkos::Experimental::HIP const &inst) {
+    return reinterpret_cast<std::uintptr_t>(inst.hip_stream());
+  }
+};
+#endif
+
+#if defined(KOKKOS_ENABLE_SYCL)
+template <> struct instance_key<Kokkos::Experimental::SYCL> {
+  static std::uintptr_t call(Kokkos::Experimental::SYCL const &inst) {
+    return reinterpret_cast<std::uintptr_t>(&(inst.sycl_queue()));
+  }
+};
+#endif
+
+#if defined(KOKKOS_ENABLE_HPX)
+template <> struct instance_key<Kokkos::Experimental::HPX> {
+  static std::uintptr_t call(Kokkos::Experimental::HPX const &inst) {
+    return inst.impl_instance_id();
+  }
+};
+#endif
+
+/// Remembers the origin of the most recent futures produced on in-order
+/// instances of ExecutionSpace. Entries hold a reference to the future so that
+/// the address of its shared state can not be reused while it is recorded.
+/// Futures that have been evicted are simply treated as coming from an unknown
+/// instance. Nothing is recorded until origins are first asked for, so that
+/// launches only pay for recording once a dependency or inline launch check
+/// uses them.
+template <typename ExecutionSpace> class future_origins {
+public:
+  static future_origins &get() {
+    static future_origins origins;
+    return origins;
+  }
+
+  /// Starts recording futures. Futures produced before are treated as coming
+  /// from an unknown instance.
+  void track() {
+    if (!tracking.load(std::memory_order_relaxed)) {
+      tracking.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  void record(std::uintptr_t key, hpx::shared_future<void> const &f) {
+    if (!tracking.load(std::memory_order_relaxed)) {
+      return;
+    }
+    std::lock_guard<hpx::spinlock> l(mutex);
+    entries[next] = entry{key, f};
+    next = (next + 1) % capacity;
+  }
+
+  bool produced_on(std::uintptr_t key, hpx::shared_future<void> const &f) {
+    track();
+    auto const *state = hpx::traits::detail::get_shared_state(f).get();
+    if (state == nullptr) {
+      return false;
+    }
+
+    std::lock_guard<hpx::spinlock> l(mutex);
+    for (auto const &e : entries) {
+      if (e.key == key &&
+          hpx::traits::detail::get_shared_state(e.future).get() == state) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns true if the most recent future recorded for key is ready, and
+  /// false if it is not or if no future is recorded for key.
+  bool last_ready(std::uintptr_t key) {
+    track();
+    std::lock_guard<hpx::spinlock> l(mutex);
+    for (std::size_t i = 1; i <= capacity; ++i) {
+      auto const &e = entries[(next + capacity - i) % capacity];
+      if (e.key == key && e.future.valid()) {
+        return e.future.is_ready();
+      }
+    }
+    return false;
+  }
+
+  /// The number of futures whose origin is remembered.
+  static constexpr std::size_t capacity = 64;
+
+private:
+  struct entry {
+    std::uintptr_t key = 0;
+    hpx::shared_future<void> future;
+  };
+
+  std::atomic<bool> tracking{false};
+  hpx::spinlock mutex;
+  std::array<entry, capacity> entries;
+  std::size_t next = 0;
+};
+
+template <typename ExecutionSpace>
+hpx::shared_future<void> record_origin(ExecutionSpace const &inst,
+                                       hpx::shared_future<void> f) {
+  static_assert(is_execution_space_in_order<ExecutionSpace>::value,
+                "only futures from in-order instances can be recorded");
+  future_origins<ExecutionSpace>::get().record(
+      instance_key<ExecutionSpace>::call(inst), f);
+  return f;
+}
+
+template <typename ExecutionSpace>
+bool produced_on_impl(std::false_type, ExecutionSpace const &,
+                      hpx::shared_future<void> const &) {
+  return false;
+}
+
+template <typename ExecutionSpace>
+bool produced_on_impl(std::true_type, ExecutionSpace const &inst,
+                      hpx::shared_future<void> const &f) {
+  return future_origins<ExecutionSpace>::get().produced_on(
+      instance_key<ExecutionSpace>::call(inst), f);
+}
+
+/// Returns true if f was returned by this library for work on inst, or on
+/// another instance sharing the same queue, and inst is in-order. Work
+/// enqueued on inst is then guaranteed to run after the work f refers to.
+///
+/// Origins are only remembered for the most recent future_origins::capacity
+/// futures of each execution space, in a table shared by all instances and
+/// protected by a spinlock that every recording launch and every lookup
+/// takes. Recording starts with the first lookup on an execution space, so
+/// programs that never pass futures as dependencies do not pay for it. Older
+/// futures, and futures produced before the first lookup, are treated as
+/// coming from an unknown instance, so a dependency on them is waited for on
+/// the host. This only costs latency, never correctness.
+template <typename ExecutionSpace>
+bool produced_on(ExecutionSpace const &inst,
+                 hpx::shared_future<void> const &f) {
+  return produced_on_impl(is_execution_space_in_order<ExecutionSpace>{}, inst,
+                          f);
+}
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,77 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains the state used while recording launches into a graph.
+
+#pragma once
+
+#include <hpx/kokkos/detail/future_origin.hpp>
+#include <hpx/kokkos/execution_spaces.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+template <typename ExecutionSpace>
+bool same_instance_impl(std::true_type, ExecutionSpace const &a,
+                        ExecutionSpace const &b) {
+  return instance_key<ExecutionSpace>::call(a) ==
+         instance_key<ExecutionSpace>::call(b);
+}
+
+// Execution spaces without in-order instances can not be distinguished and
+// are all considered the same instance.
+template <typename ExecutionSpace>
+bool same_instance_impl(std::false_type, ExecutionSpace const &,
+                        ExecutionSpace const &) {
+  return true;
+}
+
+template <typename ExecutionSpace>
+bool same_instance(ExecutionSpace const &a, ExecutionSpace const &b) {
+  return same_instance_impl(is_execution_space_in_order<ExecutionSpace>{}, a,
+                            b);
+}
+
+/// While a graph is capturing on an instance, launches on that instance from
+/// the capturing thread are appended to nodes instead of being executed.
+template <typename ExecutionSpace> struct graph_capture {
+  ExecutionSpace instance;
+  std::vector<std::function<void()>> &nodes;
+
+  static graph_capture *&current() {
+    static thread_local graph_capture *c = nullptr;
+    return c;
+  }
+
+  static graph_capture *capturing(ExecutionSpace const &inst) {
+    graph_capture *c = current();
+    return (c != nullptr && same_instance(c->instance, inst)) ? c : nullptr;
+  }
+};
+
+template <typename ExecutionSpace> class graph_capture_scope {
+public:
+  explicit graph_capture_scope(graph_capture<ExecutionSpace> &c)
+      : previous(graph_capture<ExecutionSpace>::current()) {
+    graph_capture<ExecutionSpace>::current() = &c;
+  }
+
+  ~graph_capture_scope() {
+    graph_capture<ExecutionSpace>::current() = previous;
+  }
+
+  graph_capture_scope(graph_capture_scope const &) = delete;
+  graph_capture_scope &operator=(graph_capture_scope const &) = delete;
+
+private:
+  graph_capture<ExecutionSpace> *previous;
+};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
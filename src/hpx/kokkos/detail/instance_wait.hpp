@@ -0,0 +1,157 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains helpers for making one execution space instance wait for all work
+/// currently submitted to another instance, without synchronizing on the host
+/// when the backend supports it.
+
+#pragma once
+
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/future.hpp>
+
+#include <hpx/config.hpp>
+#include <hpx/future.hpp>
+#if defined(KOKKOS_ENABLE_HPX) && KOKKOS_VERSION >= 40100 &&                  \
+    defined(KOKKOS_ENABLE_IMPL_HPX_ASYNC_DISPATCH)
+#include <hpx/execution.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+#endif
+
+#include <Kokkos_Core.hpp>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Makes waiter wait for the work currently submitted to producer. The generic
+/// version has no way of doing so on the backend and instead adds a future for
+/// producer to the dependencies that are waited for on the host.
+template <typename Waiter, typename Producer> struct instance_wait {
+  static void call(Waiter const &, Producer const &producer,
+                   std::vector<hpx::shared_future<void>> &futures) {
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY("waiting for instance using a future");
+    futures.push_back(get_future<Producer>::call(producer));
+  }
+};
+
+#if defined(KOKKOS_ENABLE_CUDA)
+template <> struct instance_wait<Kokkos::Cuda, Kokkos::Cuda> {
+  static void call(Kokkos::Cuda const &waiter, Kokkos::Cuda const &producer,
+                   std::vector<hpx::shared_future<void>> &) {
+    if (waiter.cuda_stream() == producer.cuda_stream()) {
+      return;
+    }
+
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY("stream %p waiting for stream %p",
+                                     waiter.cuda_stream(),
+                                     producer.cuda_stream());
+    cudaEvent_t e;
+    cudaError_t error = cudaEventCreateWithFlags(&e, cudaEventDisableTiming);
+    if (error == cudaSuccess) {
+      error = cudaEventRecord(e, producer.cuda_stream());
+      if (error == cudaSuccess) {
+        error = cudaStreamWaitEvent(waiter.cuda_stream(), e, 0);
+      }
+      // The event is released once the wait has completed
+      cudaEventDestroy(e);
+    }
+    if (error != cudaSuccess) {
+      HPX_THROW_EXCEPTION(
+          kernel_error, "hpx::kokkos::detail::instance_wait",
+          std::string("cudaStreamWaitEvent failed: ") +
+              cudaGetErrorString(error));
+    }
+  }
+};
+#endif
+
+#if defined(KOKKOS_ENABLE_HIP)
+template <>
+struct instance_wait<Kokkos::Experimental::HIP, Kokkos::Experimental::HIP> {
+  static void call(Kokkos::Experimental::HIP const &waiter,
+                   Kokkos::Experimental::HIP const &producer,
+                   std::vector<hpx::shared_future<void>> &) {
+    if (waiter.hip_stream() == producer.hip_stream()) {
+      return;
+    }
+
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY("stream %p waiting for stream %p",
+                                     waiter.hip_stream(),
+                                     producer.hip_stream());
+    hipEvent_t e;
+    hipError_t error = hipEventCreateWithFlags(&e, hipEventDisableTiming);
+    if (error == hipSuccess) {
+      error = hipEventRecord(e, producer.hip_stream());
+      if (error == hipSuccess) {
+        error = hipStreamWaitEvent(waiter.hip_stream(), e, 0);
+      }
+      // The event is released once the wait has completed
+      hipEventDestroy(e);
+    }
+    if (error != hipSuccess) {
+      HPX_THROW_EXCEPTION(
+          kernel_error, "hpx::kokkos::detail::instance_wait",
+          std::string("hipStreamWaitEvent failed: ") +
+              hipGetErrorString(error));
+    }
+  }
+};
+#endif
+
+#if defined(KOKKOS_ENABLE_SYCL)
+template <>
+struct instance_wait<Kokkos::Experimental::SYCL, Kokkos::Experimental::SYCL> {
+  static void call(Kokkos::Experimental::SYCL const &waiter,
+                   Kokkos::Experimental::SYCL const &producer,
+                   std::vector<hpx::shared_future<void>> &) {
+    if (&(waiter.sycl_queue()) == &(producer.sycl_queue())) {
+      return;
+    }
+
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY("SYCL queue %p waiting for SYCL queue %p",
+                                     &(waiter.sycl_queue()),
+                                     &(producer.sycl_queue()));
+    auto e = producer.sycl_queue().ext_oneapi_submit_barrier();
+    waiter.sycl_queue().ext_oneapi_submit_barrier({e});
+  }
+};
+#endif
+
+#if defined(KOKKOS_ENABLE_HPX) && KOKKOS_VERSION >= 40100 &&                  \
+    defined(KOKKOS_ENABLE_IMPL_HPX_ASYNC_DISPATCH)
+// HPX instances chain their work on a sender. Waiting for another instance is
+// done by combining the sender of the waiter with that of the producer.
+template <>
+struct instance_wait<Kokkos::Experimental::HPX, Kokkos::Experimental::HPX> {
+  static void call(Kokkos::Experimental::HPX const &waiter,
+                   Kokkos::Experimental::HPX const &producer,
+                   std::vector<hpx::shared_future<void>> &) {
+    if (waiter.impl_instance_id() == producer.impl_instance_id()) {
+      return;
+    }
+
+    HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(
+        "HPX instance %x waiting for HPX instance %x",
+        waiter.impl_instance_id(), producer.impl_instance_id());
+    namespace ex = hpx::execution::experimental;
+    // get_sender takes the sender lock of the producer itself and keeps a
+    // split copy of the sender on the producer, so that its work chain is not
+    // taken away from it
+    auto producer_sender = producer.get_sender();
+
+    std::lock_guard<hpx::spinlock> l(waiter.impl_get_sender_mutex());
+    auto &s = waiter.impl_get_sender();
+    s = ex::split(ex::when_all(std::move(s), std::move(producer_sender)));
+  }
+};
+#endif
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
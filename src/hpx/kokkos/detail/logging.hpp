@@ -5,25 +5,516 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 ///////////////////////////////////////////////////////////////////////////////
 
-/// \file Logging functionality. Provides HPX_KOKKOS_DETAIL_LOG for internal
-/// logging.
+/// \file Logging functionality. Provides HPX_KOKKOS_DETAIL_LOG and related
+/// macros for internal logging.
+///
+/// Host logging is compiled in unless HPX_KOKKOS_DISABLE_LOGGING is defined,
+/// and is enabled at runtime per category and level. Enabled messages are
+/// recorded as fixed-size binary events in a per-thread ring buffer and are
+/// formatted by a background thread. Logging in device code is compiled out
+/// unless HPX_KOKKOS_ENABLE_DEVICE_LOGGING is defined, in which case it uses
+/// printf. Defining HPX_KOKKOS_ENABLE_LOGGING enables all host logging by
+/// default and also enables device logging.
 
 #pragma once
 
+#include <hpx/runtime.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(HPX_KOKKOS_ENABLE_LOGGING) &&                                      \
+    !defined(HPX_KOKKOS_ENABLE_DEVICE_LOGGING)
+#define HPX_KOKKOS_ENABLE_DEVICE_LOGGING
+#endif
+
+namespace hpx {
+namespace kokkos {
+enum class log_level : std::uint8_t { off, error, warning, info, debug, trace };
+
+enum class log_category : std::uint8_t {
+  general,
+  launch,
+  future,
+  dependency,
+  kernel
+};
+
+namespace detail {
+constexpr std::size_t num_log_categories = 5;
+constexpr std::size_t max_log_args = 4;
+
+/// A single argument of a log message. Strings are copied, and truncated if
+/// they do not fit.
+struct log_arg {
+  enum class type : std::uint8_t {
+    signed_int,
+    unsigned_int,
+    floating,
+    pointer,
+    string
+  };
+
+  type t;
+  union {
+    std::int64_t i;
+    std::uint64_t u;
+    double d;
+    void const *p;
+    char s[24];
+  };
+
+  template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                    std::is_signed<T>::value,
+                                                int>::type = 0>
+  log_arg(T v) : t(type::signed_int), i(v) {}
+  template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                    !std::is_signed<T>::value,
+                                                int>::type = 0>
+  log_arg(T v) : t(type::unsigned_int), u(v) {}
+  template <typename T, typename std::enable_if<std::is_enum<T>::value,
+                                                int>::type = 0>
+  log_arg(T v) : t(type::signed_int), i(static_cast<std::int64_t>(v)) {}
+  log_arg(double v) : t(type::floating), d(v) {}
+  log_arg(void const *v) : t(type::pointer), p(v) {}
+  log_arg(char const *v) : t(type::string) {
+    std::strncpy(s, v != nullptr ? v : "(null)", sizeof(s) - 1);
+    s[sizeof(s) - 1] = '\0';
+  }
+  log_arg(char *v) : log_arg(static_cast<char const *>(v)) {}
+  log_arg(std::string const &v) : log_arg(v.c_str()) {}
+  log_arg() : t(type::signed_int), i(0) {}
+};
+
+struct log_event {
+  std::uint64_t time;
+  char const *format;
+  log_category category;
+  log_level level;
+  std::uint8_t num_args;
+  std::array<log_arg, max_log_args> args;
+};
+
+/// Single-producer single-consumer ring of events. The producer is the
+/// thread owning the buffer; the consumer is whoever drains the log. Events
+/// are dropped when the ring is full.
+class log_buffer {
+public:
+  static constexpr std::size_t capacity = 1024;
+
+  explicit log_buffer(std::size_t thread) : thread(thread) {}
+
+  void push(log_event const &e) {
+    auto const h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == capacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    events[h % capacity] = e;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  template <typename F> void drain(F &&f) {
+    auto t = tail.load(std::memory_order_relaxed);
+    auto const h = head.load(std::memory_order_acquire);
+    for (; t != h; ++t) {
+      f(thread, events[t % capacity]);
+    }
+    tail.store(t, std::memory_order_release);
+  }
+
+  std::size_t take_dropped() {
+    return dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::size_t const thread;
+  std::atomic<std::size_t> head{0};
+  std::atomic<std::size_t> tail{0};
+  std::atomic<std::size_t> dropped{0};
+  std::array<log_event, capacity> events;
+};
+
+inline char const *to_string(log_category c) {
+  switch (c) {
+  case log_category::general:
+    return "general";
+  case log_category::launch:
+    return "launch";
+  case log_category::future:
+    return "future";
+  case log_category::dependency:
+    return "dependency";
+  case log_category::kernel:
+    return "kernel";
+  }
+  return "unknown";
+}
+
+inline char const *to_string(log_level l) {
+  switch (l) {
+  case log_level::off:
+    return "off";
+  case log_level::error:
+    return "error";
+  case log_level::warning:
+    return "warning";
+  case log_level::info:
+    return "info";
+  case log_level::debug:
+    return "debug";
+  case log_level::trace:
+    return "trace";
+  }
+  return "unknown";
+}
+
+/// Formats a single argument for the conversion specification spec, ignoring
+/// length modifiers in spec and using the stored type of the argument.
+inline void format_log_arg(std::string &out, std::string spec,
+                           log_arg const &a) {
+  char const conversion = spec.back();
+  spec.erase(std::remove_if(spec.begin(), spec.end() - 1,
+                            [](char c) {
+                              return c == 'h' || c == 'l' || c == 'z' ||
+                                     c == 'j' || c == 't' || c == 'L';
+                            }),
+             spec.end() - 1);
+  spec.pop_back();
+
+  char buf[64];
+  switch (a.t) {
+  case log_arg::type::signed_int:
+  case log_arg::type::unsigned_int:
+    if (std::strchr("ouxX", conversion) != nullptr) {
+      std::snprintf(buf, sizeof(buf), (spec + "ll" + conversion).c_str(),
+                    static_cast<unsigned long long>(a.u));
+    } else if (a.t == log_arg::type::unsigned_int && conversion != 'd' &&
+               conversion != 'i') {
+      std::snprintf(buf, sizeof(buf), (spec + "llu").c_str(),
+                    static_cast<unsigned long long>(a.u));
+    } else {
+      std::snprintf(buf, sizeof(buf), (spec + "lld").c_str(),
+                    static_cast<long long>(a.i));
+    }
+    break;
+  case log_arg::type::floating:
+    if (std::strchr("fFeEgGaA", conversion) != nullptr) {
+      std::snprintf(buf, sizeof(buf), (spec + conversion).c_str(), a.d);
+    } else {
+      std::snprintf(buf, sizeof(buf), "%g", a.d);
+    }
+    break;
+  case log_arg::type::pointer:
+    std::snprintf(buf, sizeof(buf), "%p", a.p);
+    break;
+  case log_arg::type::string:
+    std::snprintf(buf, sizeof(buf), "%s", a.s);
+    break;
+  }
+  out += buf;
+}
+
+inline std::string format_log_event(std::size_t thread, log_event const &e) {
+  char prefix[96];
+  std::snprintf(prefix, sizeof(prefix),
+                "[host] [%llu] [thread %zu] [%s] [%s] ",
+                static_cast<unsigned long long>(e.time), thread,
+                to_string(e.category), to_string(e.level));
+  std::string out(prefix);
+
+  std::size_t arg = 0;
+  for (char const *c = e.format; *c != '\0'; ++c) {
+    if (*c != '%') {
+      out += *c;
+      continue;
+    }
+    if (c[1] == '%') {
+      out += '%';
+      ++c;
+      continue;
+    }
+    char const *end = c + 1;
+    while (*end != '\0' &&
+           std::strchr("diuoxXfFeEgGaAcspn", *end) == nullptr) {
+      ++end;
+    }
+    if (*end == '\0') {
+      break;
+    }
+    if (arg < e.num_args) {
+      format_log_arg(out, std::string(c, end + 1), e.args[arg++]);
+    }
+    c = end;
+  }
+  out += '\n';
+  return out;
+}
+
+/// Holds the runtime configuration of logging and the buffers of all threads
+/// that have logged. A background thread drains the buffers while logging is
+/// enabled.
+class logger {
+public:
+  using sink_type = std::function<void(std::string const &)>;
+
+  static logger &get() {
+    static logger l;
+    return l;
+  }
+
+  bool enabled(log_category c, log_level l) const {
+    return static_cast<std::uint8_t>(l) <=
+           levels[static_cast<std::size_t>(c)].load(std::memory_order_relaxed);
+  }
+
+  void set_level(log_category c, log_level l) {
+    levels[static_cast<std::size_t>(c)].store(static_cast<std::uint8_t>(l),
+                                              std::memory_order_relaxed);
+    if (l != log_level::off) {
+      start_drain();
+    }
+  }
 
+  void set_sink(sink_type s) {
+    std::lock_guard<std::mutex> l(drain_mutex);
+    sink = std::move(s);
+  }
+
+  template <typename... Args>
+  void log(log_category c, log_level l, char const *format,
+           Args const &...args) {
+    static_assert(sizeof...(Args) <= max_log_args,
+                  "too many arguments to a log message");
+    log_event e{static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count()),
+                format,
+                c,
+                l,
+                static_cast<std::uint8_t>(sizeof...(Args)),
+                {{log_arg(args)...}}};
+    this_thread_buffer().push(e);
+  }
+
+  /// Formats all events recorded so far and passes them to the sink.
+  void flush() {
+    std::lock_guard<std::mutex> l(drain_mutex);
+    std::vector<log_buffer *> bs;
+    {
+      std::lock_guard<std::mutex> l(buffers_mutex);
+      bs.reserve(buffers.size());
+      for (auto &b : buffers) {
+        bs.push_back(b.get());
+      }
+    }
+    for (auto *b : bs) {
+      b->drain([this](std::size_t thread, log_event const &e) {
+        sink(format_log_event(thread, e));
+      });
+      if (auto const n = b->take_dropped()) {
+        sink("[host] dropped " + std::to_string(n) + " log events\n");
+      }
+    }
+  }
+
+  ~logger() {
+    {
+      std::lock_guard<std::mutex> l(stop_mutex);
+      stop = true;
+    }
+    stop_cv.notify_one();
+    if (drain_thread.joinable()) {
+      drain_thread.join();
+    }
+    flush();
+  }
+
+private:
+  logger() {
 #if defined(HPX_KOKKOS_ENABLE_LOGGING)
+    for (std::size_t c = 0; c < num_log_categories; ++c) {
+      set_level(static_cast<log_category>(c), log_level::trace);
+    }
+#endif
+  }
+
+  log_buffer &this_thread_buffer() {
+    thread_local log_buffer *b = nullptr;
+    if (b == nullptr) {
+      std::lock_guard<std::mutex> l(buffers_mutex);
+      buffers.push_back(std::make_unique<log_buffer>(buffers.size()));
+      b = buffers.back().get();
+    }
+    return *b;
+  }
+
+  void start_drain() {
+    std::call_once(drain_started, [this] {
+      drain_thread = std::thread([this] {
+        std::unique_lock<std::mutex> l(stop_mutex);
+        while (!stop) {
+          stop_cv.wait_for(l, std::chrono::milliseconds(10));
+          l.unlock();
+          flush();
+          l.lock();
+        }
+      });
+    });
+  }
+
+  std::array<std::atomic<std::uint8_t>, num_log_categories> levels{};
+
+  std::mutex buffers_mutex;
+  std::vector<std::unique_ptr<log_buffer>> buffers;
+
+  std::mutex drain_mutex;
+  sink_type sink = [](std::string const &s) {
+    std::fputs(s.c_str(), stderr);
+  };
+
+  std::once_flag drain_started;
+  std::thread drain_thread;
+  std::mutex stop_mutex;
+  std::condition_variable stop_cv;
+  bool stop = false;
+};
+
+inline bool parse_log_level(std::string const &s, log_level &l) {
+  for (auto candidate : {log_level::off, log_level::error, log_level::warning,
+                         log_level::info, log_level::debug, log_level::trace}) {
+    if (s == to_string(candidate)) {
+      l = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace detail
+
+/// Sets the level up to which messages in category are logged.
+inline void set_log_level(log_category c, log_level l) {
+  detail::logger::get().set_level(c, l);
+}
+
+/// Sets the level up to which messages in all categories are logged.
+inline void set_log_level(log_level l) {
+  for (std::size_t c = 0; c < detail::num_log_categories; ++c) {
+    set_log_level(static_cast<log_category>(c), l);
+  }
+}
+
+/// Sets the function that formatted log messages are passed to. Messages are
+/// written to stderr by default. The sink is called from the background
+/// thread draining the log, or from the thread calling flush_log.
+inline void set_log_sink(std::function<void(std::string const &)> sink) {
+  detail::logger::get().set_sink(std::move(sink));
+}
+
+/// Formats and outputs all messages logged so far.
+inline void flush_log() { detail::logger::get().flush(); }
+
+namespace detail {
+/// Reads the log configuration from hpx.kokkos.log. The value is a comma
+/// separated list of levels, optionally prefixed with a category and a colon,
+/// e.g. "info,kernel:trace".
+inline void configure_logging() {
+  std::string const config = hpx::get_config_entry("hpx.kokkos.log", "");
+  std::size_t begin = 0;
+  while (begin < config.size()) {
+    auto end = config.find(',', begin);
+    if (end == std::string::npos) {
+      end = config.size();
+    }
+    std::string const entry = config.substr(begin, end - begin);
+    begin = end + 1;
+
+    log_level l;
+    auto const colon = entry.find(':');
+    if (colon == std::string::npos) {
+      if (parse_log_level(entry, l)) {
+        set_log_level(l);
+      }
+      continue;
+    }
+    if (!parse_log_level(entry.substr(colon + 1), l)) {
+      continue;
+    }
+    for (std::size_t c = 0; c < num_log_categories; ++c) {
+      if (entry.compare(0, colon, to_string(static_cast<log_category>(c))) ==
+          0) {
+        set_log_level(static_cast<log_category>(c), l);
+      }
+    }
+  }
+}
+
+struct logging_registration {
+  logging_registration() {
+    hpx::register_pre_startup_function(&configure_logging);
+  }
+};
+
+inline logging_registration const logging_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
+
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__) ||              \
+    defined(__SYCL_DEVICE_ONLY__)
+#if defined(HPX_KOKKOS_ENABLE_DEVICE_LOGGING) && !defined(__SYCL_DEVICE_ONLY__)
 #if defined(__CUDA_ARCH__)
 #define HPX_KOKKOS_DETAIL_LOG_HELPER(FMT, ...)                                 \
   printf("[cuda] " FMT "%s\n", __VA_ARGS__)
-#elif defined(__HIP_DEVICE_COMPILE__)
+#else
 #define HPX_KOKKOS_DETAIL_LOG_HELPER(FMT, ...)                                 \
   printf("[hip ] " FMT "%s\n", __VA_ARGS__)
+#endif
+#define HPX_KOKKOS_DETAIL_LOG_CATEGORY(CATEGORY, LEVEL, ...)                   \
+  HPX_KOKKOS_DETAIL_LOG_HELPER(__VA_ARGS__, "")
 #else
-#define HPX_KOKKOS_DETAIL_LOG_HELPER(FMT, ...)                                 \
-  printf("[host] " FMT "%s\n", __VA_ARGS__)
+#define HPX_KOKKOS_DETAIL_LOG_CATEGORY(CATEGORY, LEVEL, ...)
 #endif
-#define HPX_KOKKOS_DETAIL_LOG(...) HPX_KOKKOS_DETAIL_LOG_HELPER(__VA_ARGS__, "")
+#elif !defined(HPX_KOKKOS_DISABLE_LOGGING)
+#define HPX_KOKKOS_DETAIL_LOG_CATEGORY(CATEGORY, LEVEL, ...)                   \
+  do {                                                                         \
+    auto &hpx_kokkos_logger = ::hpx::kokkos::detail::logger::get();            \
+    if (hpx_kokkos_logger.enabled(::hpx::kokkos::log_category::CATEGORY,       \
+                                  ::hpx::kokkos::log_level::LEVEL)) {          \
+      hpx_kokkos_logger.log(::hpx::kokkos::log_category::CATEGORY,             \
+                            ::hpx::kokkos::log_level::LEVEL, __VA_ARGS__);     \
+    }                                                                          \
+  } while (false)
 #else
-#define HPX_KOKKOS_DETAIL_LOG(user_fmt, ...)
+#define HPX_KOKKOS_DETAIL_LOG_CATEGORY(CATEGORY, LEVEL, ...)
 #endif
+
+#define HPX_KOKKOS_DETAIL_LOG(...)                                             \
+  HPX_KOKKOS_DETAIL_LOG_CATEGORY(general, debug, __VA_ARGS__)
+#define HPX_KOKKOS_DETAIL_LOG_LAUNCH(...)                                      \
+  HPX_KOKKOS_DETAIL_LOG_CATEGORY(launch, debug, __VA_ARGS__)
+#define HPX_KOKKOS_DETAIL_LOG_FUTURE(...)                                      \
+  HPX_KOKKOS_DETAIL_LOG_CATEGORY(future, debug, __VA_ARGS__)
+#define HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(...)                                  \
+  HPX_KOKKOS_DETAIL_LOG_CATEGORY(dependency, debug, __VA_ARGS__)
+
+/// Logs from inside kernels, e.g. once per element. These are only enabled
+/// at the trace level.
+#define HPX_KOKKOS_DETAIL_LOG_KERNEL(...)                                      \
+  HPX_KOKKOS_DETAIL_LOG_CATEGORY(kernel, trace, __VA_ARGS__)
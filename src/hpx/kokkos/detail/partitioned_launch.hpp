@@ -0,0 +1,68 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains the launch of one-dimensional iteration ranges of HPX algorithms
+/// on the instances of an executor.
+
+#pragma once
+
+#include <hpx/future.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Returns a future that becomes ready when all futures are ready, and holds
+/// the first exception of futures, if any.
+inline hpx::shared_future<void>
+combine_futures(std::vector<hpx::shared_future<void>> futures) {
+  if (futures.size() == 1) {
+    return std::move(futures.front());
+  }
+  return hpx::shared_future<void>(
+      hpx::when_all(std::move(futures))
+          .then(hpx::launch::sync,
+                [](hpx::future<std::vector<hpx::shared_future<void>>> &&f) {
+                  for (auto &g : f.get()) {
+                    g.get();
+                  }
+                }));
+}
+
+/// Launches the iteration range [first, last) of the algorithm labeled label
+/// with Executor by calling launch(instance, block_first, block_last) for each
+/// block of the range, which submits the work on the block to instance and
+/// returns a future for it. Returns the futures of the blocks in order.
+/// Executors with a single instance launch the whole range as one block.
+/// Executors with several instances specialize this to split the range
+/// between their instances.
+template <typename Executor, typename Enable = void>
+struct partitioned_launch {
+  template <typename I, typename Launch>
+  static auto call(Executor const &exec, char const *, I first, I last,
+                   Launch &&launch) {
+    using future_type = decltype(launch(exec.instance(), first, last));
+    std::vector<future_type> futures;
+    futures.push_back(
+        std::forward<Launch>(launch)(exec.instance(), first, last));
+    return futures;
+  }
+};
+
+/// Launches [first, last) with exec as partitioned_launch does, and returns a
+/// single future for all blocks.
+template <typename Executor, typename I, typename Launch>
+hpx::shared_future<void> launch_partitioned(Executor const &exec,
+                                            char const *label, I first,
+                                            I last, Launch &&launch) {
+  return combine_futures(partitioned_launch<Executor>::call(
+      exec, label, first, last, std::forward<Launch>(launch)));
+}
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -5,30 +5,18 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 ///////////////////////////////////////////////////////////////////////////////
 
-/// \file Contains a RAII helper utility for enabling polling if HIP or CUDA is
-/// enabled, and hpx-kokkos is configured to use polling.
+/// \file Contains a RAII helper utility for enabling polling. Kept for
+/// compatibility; polling is now enabled automatically at startup and can be
+/// controlled with the API in hpx/kokkos/polling.hpp.
 
 #pragma once
 
-#include <hpx/config.hpp>
-#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
-#include <hpx/modules/async_cuda.hpp>
-#endif
-#if defined(HPX_HAVE_SYCL)
-#include <hpx/modules/async_sycl.hpp>
-#endif
+#include <hpx/kokkos/polling.hpp>
 
 namespace hpx {
 namespace kokkos {
 namespace detail {
-struct polling_helper {
-#if (defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)) && (HPX_KOKKOS_CUDA_FUTURE_TYPE == 0)
-  hpx::cuda::experimental::enable_user_polling p;
-#endif
-#if defined(HPX_HAVE_SYCL)
-  hpx::sycl::experimental::enable_user_polling p_sycl;
-#endif
-};
+using polling_helper = hpx::kokkos::polling_scope;
 } // namespace detail
 } // namespace kokkos
 } // namespace hpx
@@ -0,0 +1,189 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains the binding of HPX execution space instances to an HPX thread pool
+/// and a concurrency limit, and its application to launches.
+
+#pragma once
+
+#include <hpx/config.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/future.hpp>
+#include <hpx/include/resource_partitioner.hpp>
+#include <hpx/thread.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// The thread pool and the maximum number of concurrently running tasks of
+/// the kernels launched on a bound instance.
+struct thread_pool_binding {
+  hpx::threads::thread_pool_base *pool = nullptr;
+  std::size_t concurrency = 0;
+
+  bool contains_current_thread() const {
+    return hpx::threads::get_self_ptr() != nullptr &&
+           hpx::this_thread::get_pool() == pool;
+  }
+
+  hpx::execution::parallel_executor executor() const {
+    return hpx::execution::parallel_executor(pool);
+  }
+
+  /// Calls launch on a thread of the pool and waits for it to return. The HPX
+  /// backend of Kokkos schedules the tasks of a kernel on the pool of the
+  /// launching thread, starting from the queue of the launching worker, so
+  /// this places the kernel on the pool. Only the submission is waited for,
+  /// so that the launch is ordered with later work on the instance.
+  template <typename F> decltype(auto) submit(F &&launch) const {
+    return hpx::async(executor(), std::forward<F>(launch)).get();
+  }
+};
+
+inline hpx::threads::thread_pool_base &
+get_bound_thread_pool(std::string const &pool) {
+  return pool.empty() ? hpx::resource::get_thread_pool(0)
+                      : hpx::resource::get_thread_pool(pool);
+}
+
+/// Maps instance ids of HPX execution space instances to their bindings.
+/// An instance can only be bound once and entries are never removed, so that
+/// lookups on every launch take no lock. Kokkos numbers instances
+/// consecutively, so ids index a table of segments that are allocated on
+/// first use.
+class thread_pool_bindings {
+public:
+  static thread_pool_bindings &get() {
+    static thread_pool_bindings b;
+    return b;
+  }
+
+  void bind(std::uint32_t id, thread_pool_binding binding) {
+    if (id / segment_size >= max_segments) {
+      throw std::runtime_error("bind: Error, too many HPX instances to bind");
+    }
+
+    auto &s = segments[id / segment_size];
+    segment *current = s.load(std::memory_order_acquire);
+    if (current == nullptr) {
+      auto *created = new segment{};
+      if (s.compare_exchange_strong(current, created,
+                                    std::memory_order_acq_rel)) {
+        current = created;
+      } else {
+        delete created;
+      }
+    }
+
+    auto *b = new thread_pool_binding(std::move(binding));
+    thread_pool_binding *expected = nullptr;
+    if (!(*current)[id % segment_size].compare_exchange_strong(
+            expected, b, std::memory_order_acq_rel)) {
+      delete b;
+      throw std::runtime_error(
+          "bind: Error, an HPX instance can only be bound once");
+    }
+    any.store(true, std::memory_order_release);
+  }
+
+  thread_pool_binding const *find(std::uint32_t id) const {
+    // Launches on unbound instances only pay for this check when nothing is
+    // bound
+    if (!any.load(std::memory_order_acquire) ||
+        id / segment_size >= max_segments) {
+      return nullptr;
+    }
+    segment const *s =
+        segments[id / segment_size].load(std::memory_order_acquire);
+    return s == nullptr ? nullptr
+                        : (*s)[id % segment_size].load(
+                              std::memory_order_acquire);
+  }
+
+  /// The number of instance ids per segment.
+  static constexpr std::size_t segment_size = 256;
+  /// The number of segments, limiting the ids of bound instances.
+  static constexpr std::size_t max_segments = 4096;
+
+private:
+  using segment =
+      std::array<std::atomic<thread_pool_binding *>, segment_size>;
+
+  std::atomic<bool> any{false};
+  std::array<std::atomic<segment *>, max_segments> segments{};
+};
+
+template <typename ExecutionSpace>
+thread_pool_binding const *find_thread_pool_binding(ExecutionSpace const &) {
+  return nullptr;
+}
+
+#if defined(KOKKOS_ENABLE_HPX)
+inline thread_pool_binding const *
+find_thread_pool_binding(Kokkos::Experimental::HPX const &inst) {
+  return thread_pool_bindings::get().find(inst.impl_instance_id());
+}
+#endif
+
+template <typename T> struct is_range_policy : std::false_type {};
+
+template <typename... Properties>
+struct is_range_policy<Kokkos::RangePolicy<Properties...>> : std::true_type {};
+
+/// Applies the binding of inst to an argument of a launch. Arguments are
+/// forwarded unchanged, except for range policies on bound HPX instances.
+template <typename ExecutionSpace, typename T, typename Enable = void>
+struct bound_argument {
+  static T &&call(ExecutionSpace const &, T &&t) { return std::forward<T>(t); }
+};
+
+#if defined(KOKKOS_ENABLE_HPX)
+/// Limits the concurrency of a range policy by making its chunks large enough
+/// that the HPX backend creates at most as many tasks as the concurrency limit
+/// of the instance.
+template <typename T>
+struct bound_argument<
+    Kokkos::Experimental::HPX, T,
+    typename std::enable_if<
+        is_range_policy<typename std::decay<T>::type>::value>::type> {
+  using policy_type = typename std::decay<T>::type;
+
+  static policy_type call(Kokkos::Experimental::HPX const &inst, T &&t) {
+    policy_type policy = std::forward<T>(t);
+    auto const *binding = find_thread_pool_binding(inst);
+    if (binding == nullptr || binding->concurrency == 0) {
+      return policy;
+    }
+
+    auto const n = static_cast<std::size_t>(policy.end() - policy.begin());
+    auto const chunk_size =
+        (n + binding->concurrency - 1) / binding->concurrency;
+    if (chunk_size > static_cast<std::size_t>(policy.chunk_size())) {
+      policy.set_chunk_size(static_cast<int>(chunk_size));
+    }
+    return policy;
+  }
+};
+#endif
+
+template <typename ExecutionSpace, typename T>
+decltype(auto) bind_argument(ExecutionSpace const &inst, T &&t) {
+  return bound_argument<ExecutionSpace, T>::call(inst, std::forward<T>(t));
+}
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -12,6 +12,8 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <type_traits>
+
 namespace hpx {
 namespace kokkos {
 template <typename ExecutionSpace>
@@ -33,5 +35,57 @@ template <>
 struct is_execution_space_independent<Kokkos::Experimental::HPX>
     : std::true_type {};
 #endif
+
+/// Trait for execution spaces whose instances execute work in the order it was
+/// submitted. Work submitted to such an instance can be enqueued directly after
+/// other work on the same instance without waiting for it to complete.
+template <typename ExecutionSpace>
+struct is_execution_space_in_order : std::false_type {};
+
+#if defined(KOKKOS_ENABLE_CUDA)
+template <>
+struct is_execution_space_in_order<Kokkos::Cuda> : std::true_type {};
+#endif
+
+#if defined(KOKKOS_ENABLE_HIP)
+template <>
+struct is_execution_space_in_order<Kokkos::Experimental::HIP>
+    : std::true_type {};
+#endif
+
+#if defined(KOKKOS_ENABLE_SYCL)
+// make_independent_execution_space_instance creates in-order queues, and so
+// does Kokkos for the default instance
+template <>
+struct is_execution_space_in_order<Kokkos::Experimental::SYCL>
+    : std::true_type {};
+#endif
+
+#if defined(KOKKOS_ENABLE_HPX)
+template <>
+struct is_execution_space_in_order<Kokkos::Experimental::HPX>
+    : std::true_type {};
+#endif
+
+/// Trait for host execution spaces whose launches complete before returning to
+/// the caller. Work on such an instance can be invoked directly and its
+/// futures are always ready, so no fence or completion callback is needed.
+template <typename ExecutionSpace>
+struct is_execution_space_synchronous : std::false_type {};
+
+#if defined(KOKKOS_ENABLE_SERIAL)
+template <>
+struct is_execution_space_synchronous<Kokkos::Serial> : std::true_type {};
+#endif
+
+#if defined(KOKKOS_ENABLE_OPENMP)
+template <>
+struct is_execution_space_synchronous<Kokkos::OpenMP> : std::true_type {};
+#endif
+
+#if defined(KOKKOS_ENABLE_THREADS)
+template <>
+struct is_execution_space_synchronous<Kokkos::Threads> : std::true_type {};
+#endif
 } // namespace kokkos
 } // namespace hpx
@@ -10,17 +10,33 @@
 
 #include <hpx/kokkos/config.hpp>
 #include <hpx/kokkos/deep_copy.hpp>
+#include <hpx/kokkos/dependencies.hpp>
+#include <hpx/kokkos/detail/dispatch.hpp>
+#include <hpx/kokkos/detail/graph_capture.hpp>
 #include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/execution_spaces.hpp>
+#include <hpx/kokkos/future.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
 #include <hpx/kokkos/kokkos_algorithms.hpp>
 #include <hpx/kokkos/make_instance.hpp>
 
 #include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/functional.hpp>
+#include <hpx/future.hpp>
+#include <hpx/iterator_support/iterator_range.hpp>
 #include <hpx/numeric.hpp>
 #include <hpx/tuple.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace hpx {
 namespace kokkos {
@@ -36,6 +52,119 @@ HPX_HOST_DEVICE void invoke_helper(hpx::util::index_pack<Is...>, F &&f, A &&a,
                       hpx::get<Is>(std::forward<Tuple>(t))...);
 #endif
 }
+
+/// The kernel of bulk launches, calling f with the element i of the shape
+/// starting at b and the arguments stored in the tuple ts.
+template <typename F, typename Iter, typename... Ts>
+struct bulk_tuple_function {
+  F f;
+  Iter b;
+  hpx::tuple<Ts...> ts;
+
+  KOKKOS_INLINE_FUNCTION void operator()(int i) const {
+    HPX_KOKKOS_DETAIL_LOG_KERNEL("bulk_async_execute i = %d", i);
+    using index_pack_type =
+#if HPX_VERSION_FULL > 0x010801
+        typename hpx::detail::fused_index_pack<hpx::tuple<Ts...>>::type;
+#else
+        typename hpx::util::detail::fused_index_pack<hpx::tuple<Ts...>>::type;
+#endif
+    invoke_helper(index_pack_type{}, f, *(b + i), ts);
+  }
+};
+
+/// The kernel of bulk launches without arguments, which copies nothing but f
+/// and b to the kernel.
+template <typename F, typename Iter> struct bulk_function {
+  F f;
+  Iter b;
+
+  KOKKOS_INLINE_FUNCTION void operator()(int i) const {
+    HPX_KOKKOS_DETAIL_LOG_KERNEL("bulk_async_execute i = %d", i);
+    hpx::invoke(f, *(b + i));
+  }
+};
+
+/// The kernel of bulk launches with a single trivially copyable argument,
+/// which is stored directly instead of in a tuple.
+template <typename F, typename Iter, typename T> struct bulk_value_function {
+  F f;
+  Iter b;
+  T t;
+
+  KOKKOS_INLINE_FUNCTION void operator()(int i) const {
+    HPX_KOKKOS_DETAIL_LOG_KERNEL("bulk_async_execute i = %d", i);
+    hpx::invoke(f, *(b + i), t);
+  }
+};
+
+/// Creates the kernel of a bulk launch, using the leanest kernel that can hold
+/// ts.
+template <typename F, typename Iter, typename... Ts>
+auto make_bulk_function(F &&f, Iter b, Ts &&...ts) {
+  if constexpr (sizeof...(Ts) == 0) {
+    return bulk_function<std::decay_t<F>, Iter>{std::forward<F>(f), b};
+  } else if constexpr (sizeof...(Ts) == 1 &&
+                       (std::is_trivially_copyable<
+                            std::decay_t<Ts>>::value && ...)) {
+    return bulk_value_function<std::decay_t<F>, Iter, std::decay_t<Ts>...>{
+        std::forward<F>(f), b, std::forward<Ts>(ts)...};
+  } else {
+    return bulk_tuple_function<std::decay_t<F>, Iter, std::decay_t<Ts>...>{
+        std::forward<F>(f), b,
+        hpx::tuple<std::decay_t<Ts>...>(std::forward<Ts>(ts)...)};
+  }
+}
+
+/// Whether single launches on inst can invoke the function directly on the
+/// calling thread instead of launching a kernel. This is the case for
+/// synchronous execution spaces, which would run the kernel on the calling
+/// thread before returning anyway, unless a graph is capturing on inst.
+template <typename ExecutionSpace>
+bool invoke_directly(ExecutionSpace const &inst) {
+  if constexpr (is_execution_space_synchronous<ExecutionSpace>::value) {
+    return graph_capture<ExecutionSpace>::capturing(inst) == nullptr;
+  } else {
+    return false;
+  }
+}
+
+/// Calls f with ts on the calling thread and returns a ready future. As for a
+/// kernel, an exception thrown by f is returned in the future.
+template <typename F, typename... Ts>
+hpx::shared_future<void> invoke_to_future(F &&f, Ts &&...ts) {
+  try {
+    hpx::invoke(std::forward<F>(f), std::forward<Ts>(ts)...);
+    return hpx::make_ready_future();
+  } catch (...) {
+    return hpx::make_exceptional_future<void>(std::current_exception());
+  }
+}
+
+/// Calls launch with predecessor as a shared future once it is ready. As in
+/// launch_after, launch is called by whoever makes predecessor ready, with the
+/// scoped future strategy of the calling thread, and no HPX thread is blocked
+/// waiting for it.
+template <typename ExecutionSpace, typename Future, typename F>
+hpx::shared_future<void> launch_with_predecessor(ExecutionSpace const &inst,
+                                                 Future &&predecessor,
+                                                 F &&launch) {
+  using value_type = typename hpx::traits::future_traits<
+      typename std::decay<Future>::type>::type;
+  hpx::shared_future<value_type> p(std::forward<Future>(predecessor));
+
+  if (graph_capture<ExecutionSpace>::capturing(inst) || p.is_ready()) {
+    return launch(std::move(p));
+  }
+
+  HPX_KOKKOS_DETAIL_LOG_DEPENDENCY(
+      "deferring launch until the predecessor is ready");
+  return hpx::shared_future<void>(p.then(
+      hpx::launch::sync,
+      [launch = with_scoped_future_strategy(std::forward<F>(launch))](
+          hpx::shared_future<value_type> &&p) mutable
+      -> hpx::shared_future<void> { return launch(std::move(p)); }));
+}
 } // namespace detail
 
 /// \brief The mode of an executor. Determines whether an executor should be
@@ -56,12 +185,36 @@ public:
                  : detail::make_independent_execution_space_instance<
                        ExecutionSpace>()) {}
   explicit executor(execution_space const &instance) : inst(instance) {}
+  /// Creates an executor with an independent instance bound to the HPX thread
+  /// pool named pool, using at most concurrency workers per kernel (no limit
+  /// if 0). See make_independent_execution_space_instance.
+  explicit executor(std::string const &pool, std::size_t concurrency = 0)
+      : inst(make_independent_execution_space_instance<ExecutionSpace>(
+            pool, concurrency)) {}
 
   execution_space instance() const { return inst; }
 
+  /// Returns a copy of the executor that completes the futures of its
+  /// launches using strategy s.
+  executor with_future_strategy(future_strategy s) const {
+    auto exec = *this;
+    exec.strategy_ = s;
+    return exec;
+  }
+  future_strategy strategy() const { return strategy_; }
+
   template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    if (detail::invoke_directly(inst)) {
+      detail::instrumented(inst, "parallel_for", [&] {
+        return detail::invoke_to_future(std::forward<F>(f),
+                                        std::forward<Ts>(ts)...);
+      });
+      return;
+    }
+
     auto ts_pack = hpx::make_tuple(std::forward<Ts>(ts)...);
-    parallel_for_async(
+    detail::dispatch_with_strategy(
+        inst, strategy_, "parallel_for", detail::parallel_for_fn{},
         Kokkos::Experimental::require(
             Kokkos::RangePolicy<execution_space>(inst, 0, 1),
             Kokkos::Experimental::WorkItemProperty::HintLightWeight),
@@ -74,8 +227,16 @@ public:
 
   template <typename F, typename... Ts>
   hpx::shared_future<void> async_execute(F &&f, Ts &&...ts) {
+    if (detail::invoke_directly(inst)) {
+      return detail::instrumented(inst, "parallel_for", [&] {
+        return detail::invoke_to_future(std::forward<F>(f),
+                                        std::forward<Ts>(ts)...);
+      });
+    }
+
     auto ts_pack = hpx::make_tuple(std::forward<Ts>(ts)...);
-    return parallel_for_async(
+    return detail::dispatch_with_strategy(
+        inst, strategy_, "parallel_for", detail::parallel_for_fn{},
         Kokkos::Experimental::require(
             Kokkos::RangePolicy<execution_space>(inst, 0, 1),
             Kokkos::Experimental::WorkItemProperty::HintLightWeight),
@@ -86,33 +247,165 @@ public:
 #endif
   }
 
+  /// Launches f on all elements of the shape s and returns a single future
+  /// for all of them.
   template <typename F, typename S, typename... Ts>
-  std::vector<hpx::shared_future<void>> bulk_async_execute(F &&f, S const &s,
-                                                           Ts &&...ts) {
-    HPX_KOKKOS_DETAIL_LOG("bulk_async_execute");
-    auto ts_pack = hpx::make_tuple(std::forward<Ts>(ts)...);
+  hpx::shared_future<void> bulk_async_execute_single(F &&f, S const &s,
+                                                     Ts &&...ts) {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("bulk_async_execute");
     auto size = hpx::util::size(s);
-    auto b = hpx::util::begin(s);
 
-    return {parallel_for_async(
+    return detail::dispatch_with_strategy(
+        inst, strategy_, "parallel_for", detail::parallel_for_fn{},
         Kokkos::Experimental::require(
             Kokkos::RangePolicy<ExecutionSpace>(inst, 0, size),
             Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-        KOKKOS_LAMBDA(int i) {
-          HPX_KOKKOS_DETAIL_LOG("bulk_async_execute i = %d", i);
-          using index_pack_type =
-#if HPX_VERSION_FULL > 0x010801
-            typename hpx::detail::fused_index_pack<decltype(ts_pack)>::type;
-#else
-            typename hpx::util::detail::fused_index_pack<decltype(ts_pack)>::type;
-#endif
-          detail::invoke_helper(index_pack_type{}, f, *(b + i), ts_pack);
-        })};
+        detail::make_bulk_function(std::forward<F>(f), hpx::util::begin(s),
+                                   std::forward<Ts>(ts)...));
+  }
+
+  template <typename F, typename S, typename... Ts>
+  std::vector<hpx::shared_future<void>> bulk_async_execute(F &&f, S const &s,
+                                                           Ts &&...ts) {
+    return {bulk_async_execute_single(std::forward<F>(f), s,
+                                      std::forward<Ts>(ts)...)};
+  }
+
+  template <typename F, typename S, typename... Ts>
+  void bulk_sync_execute(F &&f, S const &s, Ts &&...ts) {
+    bulk_async_execute_single(std::forward<F>(f), s, std::forward<Ts>(ts)...)
+        .get();
+  }
+
+  /// Launches f once predecessor is ready, calling it with the ready
+  /// predecessor as a shared future followed by ts. The predecessor can only
+  /// be used on the host, so this requires an execution space that can access
+  /// host memory. See then_execute_after for continuations on device
+  /// execution spaces.
+  template <typename F, typename Future, typename... Ts>
+  hpx::shared_future<void> then_execute(F &&f, Future &&predecessor,
+                                        Ts &&...ts) {
+    static_assert(Kokkos::SpaceAccessibility<ExecutionSpace,
+                                             Kokkos::HostSpace>::accessible,
+                  "then_execute passes the predecessor to f and can only be "
+                  "used with execution spaces that can access host memory, "
+                  "use then_execute_after instead");
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("then_execute");
+    return detail::launch_with_predecessor(
+        inst, std::forward<Future>(predecessor),
+        [exec = *this, f = std::decay_t<F>(std::forward<F>(f)),
+         pack = std::tuple<std::decay_t<Ts>...>(std::forward<Ts>(ts)...)](
+            auto &&p) mutable {
+          return std::apply(
+              [&](auto &...captured) {
+                return exec.async_execute(f, std::move(p), captured...);
+              },
+              pack);
+        });
+  }
+
+  /// Launches f with ts once predecessor is ready, without passing the
+  /// predecessor to f. predecessor must be a dependency (see is_dependency)
+  /// and f is enqueued from the continuation of predecessor, or immediately
+  /// if predecessor was produced on the same in-order instance. Unlike
+  /// then_execute this can be used on device execution spaces.
+  template <typename F, typename Future, typename... Ts>
+  hpx::shared_future<void> then_execute_after(F &&f, Future &&predecessor,
+                                              Ts &&...ts) {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("then_execute_after");
+    return detail::launch_after(
+        inst, std::forward<Future>(predecessor),
+        [exec = *this, f = std::decay_t<F>(std::forward<F>(f)),
+         pack = std::tuple<std::decay_t<Ts>...>(
+             std::forward<Ts>(ts)...)]() mutable {
+          return std::apply(
+              [&](auto &...captured) {
+                return exec.async_execute(f, captured...);
+              },
+              pack);
+        });
+  }
+
+  /// Launches f on all elements of the shape s once predecessor is ready,
+  /// calling it with the element, the ready predecessor as a shared future,
+  /// and ts. As for then_execute, this requires an execution space that can
+  /// access host memory. As for bulk_async_execute, the elements of s must
+  /// stay valid until the returned future is ready.
+  template <typename F, typename S, typename Future, typename... Ts>
+  hpx::shared_future<void> bulk_then_execute(F &&f, S const &s,
+                                             Future &&predecessor, Ts &&...ts) {
+    static_assert(Kokkos::SpaceAccessibility<ExecutionSpace,
+                                             Kokkos::HostSpace>::accessible,
+                  "bulk_then_execute passes the predecessor to f and can only "
+                  "be used with execution spaces that can access host memory, "
+                  "use bulk_then_execute_after instead");
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("bulk_then_execute");
+    return detail::launch_with_predecessor(
+        inst, std::forward<Future>(predecessor),
+        [exec = *this, f = std::decay_t<F>(std::forward<F>(f)),
+         first = hpx::util::begin(s), last = hpx::util::end(s),
+         pack = std::tuple<std::decay_t<Ts>...>(std::forward<Ts>(ts)...)](
+            auto &&p) mutable {
+          return std::apply(
+              [&](auto &...captured) {
+                return exec.bulk_async_execute_single(
+                    f, hpx::util::make_iterator_range(first, last), p,
+                    captured...);
+              },
+              pack);
+        });
+  }
+
+  /// Launches f on all elements of the shape s once predecessor is ready,
+  /// calling it with the element and ts, with the same dependency handling
+  /// as then_execute_after.
+  template <typename F, typename S, typename Future, typename... Ts>
+  hpx::shared_future<void> bulk_then_execute_after(F &&f, S const &s,
+                                                   Future &&predecessor,
+                                                   Ts &&...ts) {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("bulk_then_execute_after");
+    return detail::launch_after(
+        inst, std::forward<Future>(predecessor),
+        [exec = *this, f = std::decay_t<F>(std::forward<F>(f)),
+         first = hpx::util::begin(s), last = hpx::util::end(s),
+         pack = std::tuple<std::decay_t<Ts>...>(
+             std::forward<Ts>(ts)...)]() mutable {
+          return std::apply(
+              [&](auto &...captured) {
+                return exec.bulk_async_execute_single(
+                    f, hpx::util::make_iterator_range(first, last),
+                    captured...);
+              },
+              pack);
+        });
+  }
+
+#if HPX_VERSION_FULL >= 0x010900
+  /// Customizes the bulk launch customization points used by HPX algorithms,
+  /// which accept a single future for all elements since HPX 1.9, so that
+  /// they get the future of the kernel without a vector around it.
+  template <typename F, typename S, typename... Ts>
+  friend hpx::shared_future<void>
+  tag_invoke(hpx::parallel::execution::bulk_async_execute_t,
+             executor const &exec, F &&f, S const &s, Ts &&...ts) {
+    return executor(exec).bulk_async_execute_single(std::forward<F>(f), s,
+                                                    std::forward<Ts>(ts)...);
+  }
+
+  template <typename F, typename S, typename Future, typename... Ts>
+  friend hpx::shared_future<void>
+  tag_invoke(hpx::parallel::execution::bulk_then_execute_t,
+             executor const &exec, F &&f, S const &s, Future &&predecessor,
+             Ts &&...ts) {
+    return executor(exec).bulk_then_execute(std::forward<F>(f), s,
+                                            std::forward<Future>(predecessor),
+                                            std::forward<Ts>(ts)...);
   }
+#endif
 
   hpx::shared_future<void> get_future() {
     return detail::get_future<typename std::decay<ExecutionSpace>::type>::call(
-        std::forward<ExecutionSpace>(inst));
+        inst, strategy_);
   }
 
   template <typename Parameters, typename F>
@@ -124,6 +417,7 @@ public:
 
 private:
   execution_space inst{};
+  future_strategy strategy_ = future_strategy::unspecified;
 };
 
 // Define type aliases
@@ -170,6 +464,10 @@ template <typename ExecutionSpace>
 struct is_two_way_executor<hpx::kokkos::executor<ExecutionSpace>>
     : std::true_type {};
 
+template <typename ExecutionSpace>
+struct is_bulk_one_way_executor<hpx::kokkos::executor<ExecutionSpace>>
+    : std::true_type {};
+
 template <typename ExecutionSpace>
 struct is_bulk_two_way_executor<hpx::kokkos::executor<ExecutionSpace>>
     : std::true_type {};
@@ -10,7 +10,10 @@
 
 #pragma once
 
+#include <hpx/kokkos/detail/future_origin.hpp>
 #include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/execution_spaces.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
 
 #include <hpx/config.hpp>
 #include <hpx/future.hpp>
@@ -29,74 +32,162 @@ namespace kokkos {
 namespace detail {
 template <typename ExecutionSpace = Kokkos::DefaultExecutionSpace>
 struct get_future {
-  template <typename E> static hpx::shared_future<void> call(E &&inst) {
+  template <typename E>
+  static hpx::shared_future<void>
+  call(E &&inst, future_strategy s = future_strategy::unspecified) {
+    if constexpr (is_execution_space_synchronous<ExecutionSpace>::value) {
+      // All work submitted to inst has completed already
+      HPX_KOKKOS_DETAIL_LOG_FUTURE("getting ready future of synchronous space");
+      return hpx::make_ready_future();
+    }
+
+    if (resolve_future_strategy(s) == future_strategy::fence) {
+      HPX_KOKKOS_DETAIL_LOG_FUTURE("getting future by fencing on HPX thread");
+      return fence_on_hpx_thread(inst);
+    }
+
     // The best we can do generically at the moment is to fence on the
     // instance and return a ready future. It would be nice to be able to
     // attach a callback to any execution space instance to trigger future
     // completion.
     inst.fence();
-    HPX_KOKKOS_DETAIL_LOG("getting generic ready future after fencing");
+    HPX_KOKKOS_DETAIL_LOG_FUTURE("getting generic ready future after fencing");
     return hpx::make_ready_future();
   }
 };
 
-#if defined(KOKKOS_ENABLE_CUDA)
-template <> struct get_future<Kokkos::Cuda> {
-  template <typename E> static hpx::shared_future<void> call(E &&inst) {
-    HPX_KOKKOS_DETAIL_LOG("getting future from stream %p", inst.cuda_stream());
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
 #if HPX_KOKKOS_CUDA_FUTURE_TYPE == 0
-    return hpx::cuda::experimental::detail::get_future_with_event(
-        inst.cuda_stream());
+inline constexpr future_strategy configured_cuda_future_strategy =
+    future_strategy::event;
 #elif HPX_KOKKOS_CUDA_FUTURE_TYPE == 1
-    return hpx::cuda::experimental::detail::get_future_with_callback(
-        inst.cuda_stream());
+inline constexpr future_strategy configured_cuda_future_strategy =
+    future_strategy::callback;
 #else
 #error "HPX_KOKKOS_CUDA_FUTURE_TYPE is invalid (must be 0 (event) or 1 (callback))"
 #endif
+
+/// Returns a future for the work submitted to stream so far, shared by CUDA
+/// and HIP.
+template <typename ExecutionSpace, typename Stream>
+hpx::shared_future<void> get_stream_future(ExecutionSpace const &inst,
+                                           Stream stream, future_strategy s) {
+  s = resolve_future_strategy(s);
+  bool const adaptive = s == future_strategy::adaptive;
+  if (adaptive) {
+    s = adaptive_future_statistics<ExecutionSpace>::choose(
+        future_strategy::event, future_strategy::callback);
+  }
+  if (s != future_strategy::event && s != future_strategy::callback &&
+      s != future_strategy::fence) {
+    s = configured_cuda_future_strategy;
+  }
+  HPX_KOKKOS_DETAIL_LOG_FUTURE("getting %s future from stream %p",
+                               to_string(s), stream);
+
+  hpx::shared_future<void> f;
+  if (s == future_strategy::event) {
+    f = polled(hpx::cuda::experimental::detail::get_future_with_event(stream));
+  } else if (s == future_strategy::callback) {
+    f = hpx::cuda::experimental::detail::get_future_with_callback(stream);
+  } else {
+    f = fence_on_hpx_thread(inst);
+  }
+  if (adaptive) {
+    adaptive_future_statistics<ExecutionSpace>::observe(f);
+  }
+  return record_origin(inst, f);
+}
+#endif
+
+#if defined(KOKKOS_ENABLE_CUDA)
+template <> struct get_future<Kokkos::Cuda> {
+  template <typename E>
+  static hpx::shared_future<void>
+  call(E &&inst, future_strategy s = future_strategy::unspecified) {
+    return get_stream_future(inst, inst.cuda_stream(), s);
   }
 };
 #endif
 
 #if defined(KOKKOS_ENABLE_HIP)
 template <> struct get_future<Kokkos::Experimental::HIP> {
-  template <typename E> static hpx::shared_future<void> call(E &&inst) {
-    HPX_KOKKOS_DETAIL_LOG("getting future from stream %p", inst.hip_stream());
-#if HPX_KOKKOS_CUDA_FUTURE_TYPE == 0
-    return hpx::cuda::experimental::detail::get_future_with_event(
-        inst.hip_stream());
-#elif HPX_KOKKOS_CUDA_FUTURE_TYPE == 1
-    return hpx::cuda::experimental::detail::get_future_with_callback(
-        inst.hip_stream());
-#else
-#error "HPX_KOKKOS_CUDA_FUTURE_TYPE is invalid (must be 0 (event) or 1 (callback))"
-#endif
+  template <typename E>
+  static hpx::shared_future<void>
+  call(E &&inst, future_strategy s = future_strategy::unspecified) {
+    return get_stream_future(inst, inst.hip_stream(), s);
   }
 };
 #endif
 
 #if defined(KOKKOS_ENABLE_SYCL)
-template <> struct get_future<Kokkos::Experimental::SYCL> {
-  template <typename E> static hpx::shared_future<void> call(E &&inst) {
-    HPX_KOKKOS_DETAIL_LOG("getting future from SYCL queue %p", &(inst.sycl_queue()));
 #if HPX_KOKKOS_SYCL_FUTURE_TYPE == 0
-    auto fut = hpx::sycl::experimental::detail::get_future(inst.sycl_queue());
+inline constexpr future_strategy configured_sycl_future_strategy =
+    future_strategy::event;
 #elif HPX_KOKKOS_SYCL_FUTURE_TYPE == 1
-    auto fut = hpx::sycl::experimental::detail::
-      get_future_using_host_task(inst.sycl_queue());
+inline constexpr future_strategy configured_sycl_future_strategy =
+    future_strategy::host_task;
 #else
 #error "HPX_KOKKOS_SYCL_FUTURE_TYPE is invalid (must be 0 (event) or 1 (host_task))"
 #endif
-    return fut ;
+
+/// Resolves s to one of the strategies supported by SYCL. Sets adaptive if
+/// the adaptive strategy was requested.
+inline future_strategy resolve_sycl_future_strategy(future_strategy s,
+                                                    bool &adaptive) {
+  s = resolve_future_strategy(s);
+  adaptive = s == future_strategy::adaptive;
+  if (adaptive) {
+    s = adaptive_future_statistics<Kokkos::Experimental::SYCL>::choose(
+        future_strategy::event, future_strategy::host_task);
+  }
+  if (s != future_strategy::event && s != future_strategy::host_task &&
+      s != future_strategy::fence) {
+    s = configured_sycl_future_strategy;
+  }
+  return s;
+}
+
+template <> struct get_future<Kokkos::Experimental::SYCL> {
+  template <typename E>
+  static hpx::shared_future<void>
+  call(E &&inst, future_strategy s = future_strategy::unspecified) {
+    bool adaptive = false;
+    s = resolve_sycl_future_strategy(s, adaptive);
+    HPX_KOKKOS_DETAIL_LOG_FUTURE("getting %s future from SYCL queue %p",
+                                 to_string(s), &(inst.sycl_queue()));
+    hpx::shared_future<void> f;
+    if (s == future_strategy::event) {
+      f = polled(
+          hpx::sycl::experimental::detail::get_future(inst.sycl_queue()));
+    } else if (s == future_strategy::host_task) {
+      f = hpx::sycl::experimental::detail::get_future_using_host_task(
+          inst.sycl_queue());
+    } else {
+      f = fence_on_hpx_thread(inst);
+    }
+    if (adaptive) {
+      adaptive_future_statistics<Kokkos::Experimental::SYCL>::observe(f);
+    }
+    return record_origin(inst, f);
   }
 };
 #endif
 
-#if defined(KOKKOS_ENABLE_HPX) 
+#if defined(KOKKOS_ENABLE_HPX)
 template <> struct get_future<Kokkos::Experimental::HPX> {
-  template <typename E> static hpx::shared_future<void> call(E &&inst) {
-    HPX_KOKKOS_DETAIL_LOG("getting future from HPX instance %x",
-                          inst.impl_instance_id());
-    return inst.impl_get_future();
+  template <typename E>
+  static hpx::shared_future<void>
+  call(E &&inst, future_strategy s = future_strategy::unspecified) {
+    if (resolve_future_strategy(s) == future_strategy::fence) {
+      HPX_KOKKOS_DETAIL_LOG_FUTURE(
+          "getting future by fencing HPX instance %x on HPX thread",
+          inst.impl_instance_id());
+      return record_origin(inst, fence_on_hpx_thread(inst));
+    }
+    HPX_KOKKOS_DETAIL_LOG_FUTURE("getting future from HPX instance %x",
+                                 inst.impl_instance_id());
+    return record_origin(inst, inst.impl_get_future());
   }
 };
 #endif
@@ -104,11 +195,14 @@ template <> struct get_future<Kokkos::Experimental::HPX> {
 
 /// Make a future for a particular execution space instance. This might be
 /// useful for functions that don't have *_async overloads yet but take an
-/// execution space instance for asynchronous execution.
+/// execution space instance for asynchronous execution. The future is
+/// completed using strategy s, if given.
 template <typename ExecutionSpace>
-hpx::shared_future<void> get_future(ExecutionSpace &&inst) {
+hpx::shared_future<void>
+get_future(ExecutionSpace &&inst,
+           future_strategy s = future_strategy::unspecified) {
   return detail::get_future<typename std::decay<ExecutionSpace>::type>::call(
-      std::forward<ExecutionSpace>(inst));
+      std::forward<ExecutionSpace>(inst), s);
 }
 
 /// Make a future for the default instance of an execution space. This might be
@@ -0,0 +1,328 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains the runtime selection of the strategy used to complete futures
+/// for execution space instances.
+
+#pragma once
+
+#include <hpx/kokkos/polling.hpp>
+
+#include <hpx/chrono.hpp>
+#include <hpx/future.hpp>
+#include <hpx/runtime.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+#include <hpx/thread.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace hpx {
+namespace kokkos {
+/// \brief The strategy used to complete a future for work submitted to an
+/// execution space instance.
+///
+/// Strategies that are not supported by an execution space fall back to the
+/// strategy selected at configuration time for that execution space
+/// (HPX_KOKKOS_CUDA_FUTURE_TYPE and HPX_KOKKOS_SYCL_FUTURE_TYPE).
+enum class future_strategy {
+  /// Use the strategy of the enclosing future_strategy_scope, or the global
+  /// strategy if there is none.
+  unspecified,
+  /// CUDA and HIP events or SYCL events, completed by polling.
+  event,
+  /// CUDA and HIP stream callbacks.
+  callback,
+  /// SYCL host tasks.
+  host_task,
+  /// Fence the instance on a separate HPX thread. Supported by all execution
+  /// spaces.
+  fence,
+  /// Polling for short kernels and callbacks or host tasks for long kernels,
+  /// based on the observed time for futures to become ready.
+  adaptive,
+};
+
+inline char const *to_string(future_strategy s) {
+  switch (s) {
+  case future_strategy::event:
+    return "event";
+  case future_strategy::callback:
+    return "callback";
+  case future_strategy::host_task:
+    return "host_task";
+  case future_strategy::fence:
+    return "fence";
+  case future_strategy::adaptive:
+    return "adaptive";
+  default:
+    return "unspecified";
+  }
+}
+
+namespace detail {
+inline future_strategy parse_future_strategy(std::string const &s) {
+  for (auto strategy :
+       {future_strategy::event, future_strategy::callback,
+        future_strategy::host_task, future_strategy::fence,
+        future_strategy::adaptive}) {
+    if (s == to_string(strategy)) {
+      return strategy;
+    }
+  }
+  return future_strategy::unspecified;
+}
+
+inline std::atomic<future_strategy> &global_future_strategy() {
+  static std::atomic<future_strategy> s{future_strategy::unspecified};
+  return s;
+}
+
+/// The strategies of the active future_strategy_scopes, per thread. HPX
+/// threads can suspend and resume on other worker threads, so the strategy is
+/// stored per HPX thread instead of in a thread_local. Lookups only take the
+/// lock while a scope is active somewhere.
+class scoped_future_strategies {
+public:
+  static scoped_future_strategies &get() {
+    static scoped_future_strategies s;
+    return s;
+  }
+
+  /// Returns the strategy of the calling thread.
+  future_strategy current() {
+    if (active.load(std::memory_order_acquire) == 0) {
+      return future_strategy::unspecified;
+    }
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto it = strategies.find(current_thread());
+    return it == strategies.end() ? future_strategy::unspecified : it->second;
+  }
+
+  /// Sets the strategy of the calling thread to s and returns the previous
+  /// one.
+  future_strategy exchange(future_strategy s) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto const key = current_thread();
+    auto it = strategies.find(key);
+    auto const previous =
+        it == strategies.end() ? future_strategy::unspecified : it->second;
+    if (s == future_strategy::unspecified) {
+      if (it != strategies.end()) {
+        strategies.erase(it);
+      }
+    } else if (it != strategies.end()) {
+      it->second = s;
+    } else {
+      strategies.emplace(key, s);
+    }
+    active.store(strategies.size(), std::memory_order_release);
+    return previous;
+  }
+
+private:
+  // HPX threads are identified by their thread_self, which does not change
+  // when they are suspended. Other threads do not migrate.
+  static void const *current_thread() {
+    if (auto const *self = hpx::threads::get_self_ptr()) {
+      return self;
+    }
+    static thread_local char os_thread;
+    return &os_thread;
+  }
+
+  hpx::spinlock mutex;
+  std::atomic<std::size_t> active{0};
+  std::unordered_map<void const *, future_strategy> strategies;
+};
+
+/// Sets the strategy of the calling thread to s, including unspecified, for
+/// the lifetime of the object. Used to run deferred launches with the
+/// strategy of the thread that made them.
+class future_strategy_override {
+public:
+  explicit future_strategy_override(future_strategy s)
+      : previous(scoped_future_strategies::get().exchange(s)) {}
+
+  ~future_strategy_override() {
+    scoped_future_strategies::get().exchange(previous);
+  }
+
+  future_strategy_override(future_strategy_override const &) = delete;
+  future_strategy_override &
+  operator=(future_strategy_override const &) = delete;
+
+private:
+  future_strategy previous;
+};
+
+inline std::atomic<std::int64_t> &adaptive_future_threshold_ns() {
+  static std::atomic<std::int64_t> t{100000};
+  return t;
+}
+
+/// Returns the strategy to use for a future requested with strategy s. The
+/// result is unspecified if the configured strategy of the execution space
+/// should be used.
+inline future_strategy resolve_future_strategy(future_strategy s) {
+  if (s != future_strategy::unspecified) {
+    return s;
+  }
+  auto const scoped = scoped_future_strategies::get().current();
+  if (scoped != future_strategy::unspecified) {
+    return scoped;
+  }
+  return global_future_strategy().load(std::memory_order_relaxed);
+}
+
+/// Returns a callable that calls f with the scoped strategy of the calling
+/// thread, for launches that are deferred to whichever thread completes their
+/// dependencies.
+template <typename F> auto with_scoped_future_strategy(F &&f) {
+  return [s = scoped_future_strategies::get().current(),
+          f = std::forward<F>(f)](auto &&...args) mutable -> decltype(auto) {
+    future_strategy_override o(s);
+    return f(std::forward<decltype(args)>(args)...);
+  };
+}
+
+/// Keeps a moving average of the time futures take to become ready on
+/// ExecutionSpace, used to pick between polling and notification for the
+/// adaptive strategy.
+template <typename ExecutionSpace> class adaptive_future_statistics {
+public:
+  /// Returns short_strategy if futures have recently become ready within the
+  /// adaptive threshold, and long_strategy otherwise.
+  static future_strategy choose(future_strategy short_strategy,
+                                future_strategy long_strategy) {
+    return average_ns().load(std::memory_order_relaxed) <
+                   adaptive_future_threshold_ns().load(
+                       std::memory_order_relaxed)
+               ? short_strategy
+               : long_strategy;
+  }
+
+  static hpx::shared_future<void> observe(hpx::shared_future<void> f) {
+    auto const start = hpx::chrono::high_resolution_clock::now();
+    f.then(hpx::launch::sync, [start](auto &&) {
+      auto const elapsed = static_cast<std::int64_t>(
+          hpx::chrono::high_resolution_clock::now() - start);
+      // Exponential moving average with weight 1/8 for new samples. Races
+      // between concurrent updates only lose samples.
+      auto &average = average_ns();
+      auto const old = average.load(std::memory_order_relaxed);
+      average.store(old + (elapsed - old) / 8, std::memory_order_relaxed);
+    });
+    return f;
+  }
+
+  static std::int64_t average() {
+    return average_ns().load(std::memory_order_relaxed);
+  }
+
+private:
+  static std::atomic<std::int64_t> &average_ns() {
+    static std::atomic<std::int64_t> a{0};
+    return a;
+  }
+};
+
+/// Returns a future that becomes ready when all work submitted to inst so far
+/// has completed, by fencing inst on a separate HPX thread. The polling task
+/// does the fence if adaptive polling is enabled.
+template <typename ExecutionSpace>
+hpx::shared_future<void> fence_on_hpx_thread(ExecutionSpace const &inst) {
+  auto &p = poller::get();
+  if (p.enabled()) {
+    return p.fence(inst);
+  }
+  return hpx::async([inst] { inst.fence(); });
+}
+} // namespace detail
+
+/// Sets the strategy used for futures when none is given for a call, an
+/// executor, or a scope. The default is future_strategy::unspecified, which
+/// uses the strategy selected at configuration time. Can also be set at
+/// startup with --hpx:ini=hpx.kokkos.future_strategy=<strategy>.
+inline void set_future_strategy(future_strategy s) {
+  detail::global_future_strategy().store(s, std::memory_order_relaxed);
+}
+
+inline future_strategy get_future_strategy() {
+  return detail::global_future_strategy().load(std::memory_order_relaxed);
+}
+
+/// Sets the average time for futures to become ready below which the adaptive
+/// strategy uses polling instead of callbacks or host tasks. The default is
+/// 100 microseconds.
+inline void set_adaptive_future_threshold(std::chrono::nanoseconds t) {
+  detail::adaptive_future_threshold_ns().store(t.count(),
+                                               std::memory_order_relaxed);
+}
+
+/// \brief Uses a future strategy for the futures created by the calling thread
+/// for the lifetime of the object, unless a strategy is given explicitly. On
+/// HPX threads the scope belongs to the HPX thread, also while it is
+/// suspended, and does not apply to other HPX threads.
+class future_strategy_scope {
+public:
+  explicit future_strategy_scope(future_strategy s)
+      : set(s != future_strategy::unspecified),
+        previous(set ? detail::scoped_future_strategies::get().exchange(s)
+                     : future_strategy::unspecified) {}
+
+  ~future_strategy_scope() {
+    if (set) {
+      detail::scoped_future_strategies::get().exchange(previous);
+    }
+  }
+
+  future_strategy_scope(future_strategy_scope const &) = delete;
+  future_strategy_scope &operator=(future_strategy_scope const &) = delete;
+
+private:
+  bool set;
+  future_strategy previous;
+};
+
+namespace detail {
+/// Calls f with the future strategy s, if given, applying to the launches
+/// made by f. The strategy does not apply to waits for the returned futures.
+template <typename F>
+decltype(auto) launch_with_future_strategy(future_strategy s, F &&f) {
+  future_strategy_scope scope(s);
+  return std::forward<F>(f)();
+}
+} // namespace detail
+
+namespace detail {
+inline void register_future_strategy() {
+  std::string const s =
+      hpx::get_config_entry("hpx.kokkos.future_strategy", "");
+  if (!s.empty()) {
+    set_future_strategy(parse_future_strategy(s));
+  }
+}
+
+struct future_strategy_registration {
+  future_strategy_registration() {
+    hpx::register_pre_startup_function(&register_future_strategy);
+  }
+};
+
+inline future_strategy_registration const
+    future_strategy_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,90 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains a graph type for recording a sequence of asynchronous launches on
+/// an execution space instance and replaying it later.
+
+#pragma once
+
+#include <hpx/kokkos/dependencies.hpp>
+#include <hpx/kokkos/detail/graph_capture.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/executors.hpp>
+#include <hpx/kokkos/future.hpp>
+#include <hpx/kokkos/instrumentation.hpp>
+
+#include <hpx/future.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// \brief A sequence of launches recorded on an execution space instance.
+///
+/// Kernels and copies launched on the instance of the graph from within
+/// capture are recorded instead of being executed. launch enqueues all
+/// recorded work in order and returns a single future for the whole sequence.
+/// Futures returned by launches during capture are ready placeholders and must
+/// not be used for synchronization.
+template <typename ExecutionSpace = Kokkos::DefaultExecutionSpace> class graph {
+public:
+  using execution_space = ExecutionSpace;
+
+  explicit graph(execution_space const &instance = execution_space{})
+      : inst(instance) {}
+  explicit graph(executor<execution_space> const &exec)
+      : inst(exec.instance()) {}
+
+  /// Calls f with the instance of the graph and records the launches it makes
+  /// on that instance. Capturing again appends to the recorded launches. f
+  /// must not suspend the calling HPX thread.
+  template <typename F> graph &capture(F &&f) {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("capturing graph");
+    detail::graph_capture<execution_space> c{inst, nodes};
+    detail::graph_capture_scope<execution_space> scope(c);
+    std::forward<F>(f)(inst);
+    return *this;
+  }
+
+  /// Enqueues the recorded launches and returns a future that becomes ready
+  /// when all of them have completed.
+  hpx::shared_future<void> launch() {
+    HPX_KOKKOS_DETAIL_LOG_LAUNCH("launching graph with %zu nodes",
+                                 nodes.size());
+    return detail::instrumented(inst, "graph", [this] {
+      for (auto &node : nodes) {
+        node();
+      }
+      return detail::get_future<execution_space>::call(inst);
+    });
+  }
+
+  /// Enqueues the recorded launches once the given dependencies are ready. The
+  /// graph must be kept alive until the returned future is ready.
+  template <typename Dependencies,
+            typename Enable = typename std::enable_if<is_dependency<
+                typename std::decay<Dependencies>::type>::value>::type>
+  hpx::shared_future<void> launch(Dependencies &&deps) {
+    return detail::launch_after(inst, std::forward<Dependencies>(deps),
+                                [this] { return launch(); });
+  }
+
+  std::size_t size() const { return nodes.size(); }
+  void clear() { nodes.clear(); }
+  execution_space instance() const { return inst; }
+
+private:
+  execution_space inst;
+  std::vector<std::function<void()>> nodes;
+};
+} // namespace kokkos
+} // namespace hpx
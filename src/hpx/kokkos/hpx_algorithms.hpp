@@ -11,3 +11,4 @@
 #include <hpx/kokkos/hpx_algorithms_for_each.hpp>
 #include <hpx/kokkos/hpx_algorithms_for_loop.hpp>
 #include <hpx/kokkos/hpx_algorithms_reduce.hpp>
+#include <hpx/kokkos/hpx_algorithms_transform.hpp>
@@ -8,7 +8,11 @@
 
 #pragma once
 
+#include <hpx/kokkos/autotune.hpp>
 #include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/partitioned_launch.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/inline_launch.hpp>
 #include <hpx/kokkos/policy.hpp>
 
 #include <hpx/algorithm.hpp>
@@ -16,93 +20,106 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
+#include <iterator>
 #include <utility>
 
 namespace hpx {
 namespace kokkos {
 namespace detail {
 
-template <typename ExecutionSpace, typename IterB, typename IterE, typename F>
+/// Launches f on the elements [begin, end) of the sequence starting at first.
+template <typename ExecutionSpace, typename Iter, typename F>
+hpx::shared_future<void>
+for_each_helper(char const *label, ExecutionSpace &&instance, Iter first,
+                std::ptrdiff_t begin, std::ptrdiff_t end, F &&f) {
+  auto const kernel = KOKKOS_LAMBDA(int const i) {
+    HPX_KOKKOS_DETAIL_LOG_KERNEL("for_each i = %d", i);
+    hpx::invoke(f, *(first + i));
+  };
+  return tuned_range_launch(label, instance, begin, end,
+                            [&](auto const &policy) {
+                              return parallel_for_async(label, policy, kernel);
+                            });
+}
+
+template <typename Executor, typename IterB, typename IterE, typename F>
 hpx::shared_future<void> for_each_helper(char const *label,
-                                         ExecutionSpace &&instance, IterB first,
+                                         Executor const &exec, IterB first,
                                          IterE last, F &&f) {
-  return parallel_for_async(
-      label,
-      Kokkos::Experimental::require(
-          Kokkos::RangePolicy<ExecutionSpace>(instance, 0,
-                                              std::distance(first, last)),
-          Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-      KOKKOS_LAMBDA(int const i) {
-        HPX_KOKKOS_DETAIL_LOG("for_each i = %d", i);
-        hpx::invoke(f, *(first + i));
+  return launch_partitioned(
+      exec, label, std::ptrdiff_t(0),
+      std::ptrdiff_t(std::distance(first, last)),
+      [&](auto &&instance, std::ptrdiff_t begin, std::ptrdiff_t end) {
+        return for_each_helper(label,
+                               std::forward<decltype(instance)>(instance),
+                               first, begin, end, f);
       });
 }
 
-template <typename ExecutionSpace, typename F, typename... Args>
+template <typename Executor, typename F, typename... Args>
 hpx::shared_future<void>
-for_each_kokkos_policy_helper(char const *label, ExecutionSpace &&instance,
+for_each_kokkos_policy_helper(char const *label, Executor const &exec,
                               Kokkos::RangePolicy<Args...> const &p, F &&f) {
-
-  return parallel_for_async(
-      label,
-      Kokkos::Experimental::require(
-          Kokkos::RangePolicy<typename std::decay<ExecutionSpace>::type>(
-              instance, p.begin(), p.end()),
-          Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-      std::forward<F>(f));
+  using index_type = typename Kokkos::RangePolicy<Args...>::member_type;
+  return launch_partitioned(
+      exec, label, index_type(p.begin()), index_type(p.end()),
+      [&](auto &&instance, index_type begin, index_type end) {
+        return tuned_range_launch(label, instance, begin, end,
+                                  [&](auto const &policy) {
+                                    return parallel_for_async(label, policy,
+                                                              f);
+                                  });
+      });
 }
 
-template <typename ExecutionSpace, typename F, typename... Args>
+template <typename Executor, typename F, typename... Args>
 hpx::shared_future<void>
-for_each_kokkos_policy_helper(char const *label, ExecutionSpace &&instance,
+for_each_kokkos_policy_helper(char const *label, Executor const &exec,
                               Kokkos::MDRangePolicy<Args...> const &p, F &&f) {
-
   return parallel_for_async(
       label,
       Kokkos::Experimental::require(
           Kokkos::MDRangePolicy<
-              typename std::decay<ExecutionSpace>::type,
+              typename Executor::execution_space,
               Kokkos::Rank<Kokkos::MDRangePolicy<Args...>::rank>>(
-              instance, p.m_lower, p.m_upper, p.m_tile),
+              exec.instance(), p.m_lower, p.m_upper, p.m_tile),
           Kokkos::Experimental::WorkItemProperty::HintLightWeight),
       std::forward<F>(f));
 }
 
-template <typename ExecutionSpace, typename F, typename... Args>
+template <typename Executor, typename F, typename... Args>
 hpx::shared_future<void>
-for_each_kokkos_policy_helper(char const *label, ExecutionSpace &&instance,
+for_each_kokkos_policy_helper(char const *label, Executor const &exec,
                               Kokkos::TeamPolicy<Args...> const &p, F &&f) {
-
   static_assert(
-      sizeof(ExecutionSpace) == 0,
+      sizeof(Executor) == 0,
       "for_each overload cannot currently be used with Kokkos::TeamPolicy");
   return {};
 }
 
-template <typename ExecutionSpace, typename Range, typename F,
+template <typename Executor, typename Range, typename F,
           typename std::enable_if<Kokkos::is_execution_policy<
                                       typename std::decay<Range>::type>::value,
                                   int>::type = 0>
 hpx::shared_future<void> for_each_range_helper(char const *label,
-                                               ExecutionSpace &&instance,
+                                               Executor const &exec,
                                                Range &&range, F &&f) {
-  return for_each_kokkos_policy_helper(
-      label, std::forward<ExecutionSpace>(instance), std::forward<Range>(range),
-      std::forward<F>(f));
+  return for_each_kokkos_policy_helper(label, exec, std::forward<Range>(range),
+                                       std::forward<F>(f));
 }
 
 template <
-    typename ExecutionSpace, typename Range, typename F,
+    typename Executor, typename Range, typename F,
     typename std::enable_if<
         !Kokkos::is_execution_policy<typename std::decay<Range>::type>::value &&
             hpx::traits::is_range<Range>::value,
         int>::type = 0>
 hpx::shared_future<void> for_each_range_helper(char const *label,
-                                               ExecutionSpace &&instance,
+                                               Executor const &exec,
                                                Range &&range, F &&f) {
-  return for_each_helper(label, std::forward<ExecutionSpace>(instance),
-                         hpx::util::begin(range), hpx::util::end(range),
-                         std::forward<F>(f));
+  return for_each_helper(label, exec, hpx::util::begin(range),
+                         hpx::util::end(range), std::forward<F>(f));
 }
 } // namespace detail
 
@@ -112,9 +129,23 @@ template <typename ExecutionPolicy, typename Iter, typename F,
               is_kokkos_execution_policy<std::decay_t<ExecutionPolicy>>::value>>
 auto tag_invoke(hpx::for_each_t, ExecutionPolicy &&policy, Iter first,
                 Iter last, F &&f) {
+  auto const n = std::distance(first, last);
   return detail::get_policy_result<ExecutionPolicy>::call(
-      detail::for_each_helper(policy.label(), policy.executor().instance(),
-                              first, last, std::forward<F>(f)));
+      detail::launch_or_run_inline(
+          policy, std::size_t(n),
+          [&] {
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+              hpx::invoke(f, *(first + i));
+            }
+          },
+          [&] {
+            return detail::launch_with_future_strategy(
+                policy.executor().strategy(), [&] {
+                  return detail::for_each_helper(policy.label(),
+                                                 policy.executor(), first,
+                                                 last, std::forward<F>(f));
+                });
+          }));
 }
 
 // For each range customization
@@ -124,9 +155,11 @@ template <typename ExecutionPolicy, typename Range, typename F,
 auto tag_invoke(hpx::ranges::for_each_t, ExecutionPolicy &&policy, Range &&r,
                 F &&f) {
   return detail::get_policy_result<ExecutionPolicy>::call(
-      detail::for_each_range_helper(
-          policy.label(), policy.executor().instance(), std::forward<Range>(r),
-          std::forward<F>(f)));
+      detail::launch_with_future_strategy(policy.executor().strategy(), [&] {
+        return detail::for_each_range_helper(policy.label(), policy.executor(),
+                                             std::forward<Range>(r),
+                                             std::forward<F>(f));
+      }));
 }
 } // namespace kokkos
 } // namespace hpx
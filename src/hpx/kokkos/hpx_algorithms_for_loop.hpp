@@ -8,13 +8,19 @@
 
 #pragma once
 
+#include <hpx/kokkos/autotune.hpp>
 #include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/partitioned_launch.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/inline_launch.hpp>
 #include <hpx/kokkos/policy.hpp>
 
 #include <hpx/algorithm.hpp>
+#include <hpx/functional.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
 #include <utility>
 
 namespace hpx {
@@ -24,12 +30,10 @@ template <typename ExecutionSpace, typename I, typename F>
 hpx::shared_future<void>
 for_loop_helper(char const *label, ExecutionSpace &&instance,
                 typename std::decay<I>::type first, I last, F &&f) {
-  return parallel_for_async(
-      label,
-      Kokkos::Experimental::require(
-          Kokkos::RangePolicy<ExecutionSpace>(instance, first, last),
-          Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-      std::forward<F>(f));
+  return tuned_range_launch(label, instance, first, last,
+                            [&](auto const &policy) {
+                              return parallel_for_async(label, policy, f);
+                            });
 }
 
 template <typename ExecutionSpace, typename I, std::size_t N, typename F>
@@ -37,12 +41,10 @@ hpx::shared_future<void> for_loop_helper(char const *label,
                                          ExecutionSpace &&instance,
                                          Kokkos::Array<I, N> const &first,
                                          Kokkos::Array<I, N> last, F &&f) {
-  return parallel_for_async(
-      Kokkos::Experimental::require(
-          Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<N>,
-                                Kokkos::IndexType<I>>(instance, first, last),
-          Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-      std::forward<F>(f));
+  return tuned_mdrange_launch(label, instance, first, last,
+                              [&](auto const &policy) {
+                                return parallel_for_async(label, policy, f);
+                              });
 }
 } // namespace detail
 
@@ -51,9 +53,29 @@ template <typename ExecutionPolicy, typename I, typename F,
               is_kokkos_execution_policy<std::decay_t<ExecutionPolicy>>::value>>
 auto tag_invoke(hpx::experimental::for_loop_t, ExecutionPolicy &&policy,
                 typename std::decay<I>::type first, I last, F &&f) {
+  using index_type = typename std::decay<I>::type;
   return detail::get_policy_result<ExecutionPolicy>::call(
-      detail::for_loop_helper(policy.label(), policy.executor().instance(),
-                              first, last, std::forward<F>(f)));
+      detail::launch_or_run_inline(
+          policy, last > first ? std::size_t(last - first) : 0,
+          [&] {
+            for (index_type i = first; i < index_type(last); ++i) {
+              hpx::invoke(f, i);
+            }
+          },
+          [&] {
+            return detail::launch_with_future_strategy(
+                policy.executor().strategy(), [&] {
+                  return detail::launch_partitioned(
+                      policy.executor(), policy.label(), first,
+                      index_type(last),
+                      [&](auto &&instance, auto block_first, auto block_last) {
+                        return detail::for_loop_helper(
+                            policy.label(),
+                            std::forward<decltype(instance)>(instance),
+                            block_first, block_last, f);
+                      });
+                });
+          }));
 }
 
 template <typename ExecutionPolicy, typename I, std::size_t N, typename F,
@@ -63,8 +85,11 @@ auto tag_invoke(hpx::experimental::for_loop_t, ExecutionPolicy &&policy,
                 Kokkos::Array<I, N> const &first,
                 Kokkos::Array<I, N> const &last, F &&f) {
   return detail::get_policy_result<ExecutionPolicy>::call(
-      detail::for_loop_helper(policy.label(), policy.executor().instance(),
-                              first, last, std::forward<F>(f)));
+      detail::launch_with_future_strategy(policy.executor().strategy(), [&] {
+        return detail::for_loop_helper(policy.label(),
+                                       policy.executor().instance(), first,
+                                       last, std::forward<F>(f));
+      }));
 }
 
 template <typename ExecutionPolicy, typename I, std::size_t N, typename F,
@@ -74,8 +99,11 @@ auto tag_invoke(hpx::experimental::for_loop_t, ExecutionPolicy &&policy,
                 Kokkos::Array<I, N> const &first, std::initializer_list<I> last,
                 F &&f) {
   return detail::get_policy_result<ExecutionPolicy>::call(
-      detail::for_loop_helper(policy.label(), policy.executor().instance(),
-                              first, last, f));
+      detail::launch_with_future_strategy(policy.executor().strategy(), [&] {
+        return detail::for_loop_helper(policy.label(),
+                                       policy.executor().instance(), first,
+                                       last, f);
+      }));
 }
 } // namespace kokkos
 } // namespace hpx
@@ -8,7 +8,11 @@
 
 #pragma once
 
+#include <hpx/kokkos/autotune.hpp>
 #include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/partitioned_launch.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/inline_launch.hpp>
 #include <hpx/kokkos/policy.hpp>
 
 #include <hpx/algorithm.hpp>
@@ -16,7 +20,10 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 namespace hpx {
 namespace kokkos {
@@ -56,29 +63,63 @@ template <typename ExecutionSpace>
 using reduce_result_space_t =
     typename reduce_result_space<ExecutionSpace>::type;
 
-template <typename ExecutionSpace, typename IterB, typename IterE, typename T,
+/// Reduces the elements [begin, end) of the sequence starting at first with f,
+/// starting from a value-initialized T.
+template <typename ExecutionSpace, typename Iter, typename T, typename F>
+hpx::shared_future<T> reduce_block_helper(char const *label,
+                                          ExecutionSpace &&instance,
+                                          Iter first, std::ptrdiff_t begin,
+                                          std::ptrdiff_t end, F const &f) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  Kokkos::View<T, reduce_result_space_t<execution_space>> result(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "reduce_result"));
+
+  auto const kernel = KOKKOS_LAMBDA(int const i, T &update) {
+    HPX_KOKKOS_DETAIL_LOG_KERNEL("reduce i = %d", i);
+    update = hpx::invoke(f, update, *(first + i));
+  };
+  return tuned_range_launch(label, instance, begin, end,
+                            [&](auto const &policy) {
+                              return parallel_reduce_async(label, policy,
+                                                           kernel, result);
+                            })
+      .then(hpx::launch::sync,
+            [result](hpx::shared_future<void> &&) { return result(); });
+}
+
+/// Reduces [first, last) in one block per instance of exec, and combines the
+/// results of the blocks in order with init.
+template <typename Executor, typename IterB, typename IterE, typename T,
           typename F>
-hpx::shared_future<T> reduce_helper(char const *label,
-                                    ExecutionSpace &&instance, IterB first,
-                                    IterE last, T init, F &&f) {
-  Kokkos::View<T,
-               reduce_result_space_t<typename std::decay<ExecutionSpace>::type>>
-      result(Kokkos::view_alloc(Kokkos::WithoutInitializing, "reduce_result"));
-
-  return parallel_reduce_async(
-             label,
-             Kokkos::Experimental::require(
-                 Kokkos::RangePolicy<ExecutionSpace>(
-                     instance, 0, std::distance(first, last)),
-                 Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-             KOKKOS_LAMBDA(int const i, T &update) {
-               HPX_KOKKOS_DETAIL_LOG("reduce i = %d", i);
-               update = hpx::invoke(f, update, *(first + i));
-             },
-             result)
-      .then(hpx::launch::sync, [f, init, result](hpx::shared_future<void> &&) {
-        return hpx::invoke(f, init, result());
+hpx::shared_future<T> reduce_helper(char const *label, Executor const &exec,
+                                    IterB first, IterE last, T init, F &&f) {
+  auto blocks = partitioned_launch<Executor>::call(
+      exec, label, std::ptrdiff_t(0),
+      std::ptrdiff_t(std::distance(first, last)),
+      [&](auto &&instance, std::ptrdiff_t begin, std::ptrdiff_t end) {
+        return reduce_block_helper<decltype(instance), IterB, T>(
+            label, std::forward<decltype(instance)>(instance), first, begin,
+            end, f);
       });
+
+  if (blocks.size() == 1) {
+    return blocks.front().then(
+        hpx::launch::sync,
+        [f = std::forward<F>(f), init](hpx::shared_future<T> &&r) {
+          return hpx::invoke(f, init, r.get());
+        });
+  }
+
+  return hpx::when_all(std::move(blocks))
+      .then(hpx::launch::sync,
+            [f = std::forward<F>(f),
+             init](hpx::future<std::vector<hpx::shared_future<T>>> &&r) {
+              T result = init;
+              for (auto &block : r.get()) {
+                result = hpx::invoke(f, result, block.get());
+              }
+              return result;
+            });
 }
 } // namespace detail
 
@@ -88,9 +129,25 @@ template <typename ExecutionPolicy, typename Iter, typename T, typename F,
               is_kokkos_execution_policy<std::decay_t<ExecutionPolicy>>::value>>
 auto tag_invoke(hpx::reduce_t, ExecutionPolicy &&policy, Iter first, Iter last,
                 T init, F &&f) {
+  auto const n = std::distance(first, last);
   return detail::get_policy_result<ExecutionPolicy>::call(
-      detail::reduce_helper(policy.label(), policy.executor().instance(), first,
-                            last, init, std::forward<F>(f)));
+      detail::launch_or_run_inline(
+          policy, std::size_t(n),
+          [&] {
+            T result = init;
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+              result = hpx::invoke(f, result, *(first + i));
+            }
+            return result;
+          },
+          [&] {
+            return detail::launch_with_future_strategy(
+                policy.executor().strategy(), [&] {
+                  return detail::reduce_helper(policy.label(),
+                                               policy.executor(), first, last,
+                                               init, std::forward<F>(f));
+                });
+          }));
 }
 } // namespace kokkos
 } // namespace hpx
@@ -0,0 +1,95 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file Contains specializations of HPX algorithms for the Kokkos execution
+/// policy.
+
+#pragma once
+
+#include <hpx/kokkos/autotune.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/partitioned_launch.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/inline_launch.hpp>
+#include <hpx/kokkos/policy.hpp>
+
+#include <hpx/algorithm.hpp>
+#include <hpx/functional.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Writes f applied to the elements [begin, end) of the sequence starting at
+/// first to the same elements of the sequence starting at dest.
+template <typename ExecutionSpace, typename IterIn, typename IterOut,
+          typename F>
+hpx::shared_future<void>
+transform_block_helper(char const *label, ExecutionSpace &&instance,
+                       IterIn first, IterOut dest, std::ptrdiff_t begin,
+                       std::ptrdiff_t end, F const &f) {
+  auto const kernel = KOKKOS_LAMBDA(int const i) {
+    HPX_KOKKOS_DETAIL_LOG_KERNEL("transform i = %d", i);
+    *(dest + i) = hpx::invoke(f, *(first + i));
+  };
+  return tuned_range_launch(label, instance, begin, end,
+                            [&](auto const &policy) {
+                              return parallel_for_async(label, policy, kernel);
+                            });
+}
+
+template <typename Executor, typename IterIn, typename IterOut, typename F>
+hpx::shared_future<IterOut> transform_helper(char const *label,
+                                             Executor const &exec,
+                                             IterIn first, IterIn last,
+                                             IterOut dest, F &&f) {
+  auto const n = std::distance(first, last);
+  return launch_partitioned(
+             exec, label, std::ptrdiff_t(0), std::ptrdiff_t(n),
+             [&](auto &&instance, std::ptrdiff_t begin, std::ptrdiff_t end) {
+               return transform_block_helper(
+                   label, std::forward<decltype(instance)>(instance), first,
+                   dest, begin, end, f);
+             })
+      .then(hpx::launch::sync, [dest, n](hpx::shared_future<void> &&done) {
+        done.get();
+        return std::next(dest, n);
+      });
+}
+} // namespace detail
+
+// Transform non-range overload
+template <typename ExecutionPolicy, typename IterIn, typename IterOut,
+          typename F,
+          typename Enable = std::enable_if_t<
+              is_kokkos_execution_policy<std::decay_t<ExecutionPolicy>>::value>>
+auto tag_invoke(hpx::transform_t, ExecutionPolicy &&policy, IterIn first,
+                IterIn last, IterOut dest, F &&f) {
+  auto const n = std::distance(first, last);
+  return detail::get_policy_result<ExecutionPolicy>::call(
+      detail::launch_or_run_inline(
+          policy, std::size_t(n),
+          [&] {
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+              *(dest + i) = hpx::invoke(f, *(first + i));
+            }
+            return std::next(dest, n);
+          },
+          [&] {
+            return detail::launch_with_future_strategy(
+                policy.executor().strategy(), [&] {
+                  return detail::transform_helper(
+                      policy.label(), policy.executor(), first, last, dest,
+                      std::forward<F>(f));
+                });
+          }));
+}
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,240 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains the fast path of HPX algorithms that runs small ranges inline on
+/// the calling thread instead of launching a kernel, and the calibration of
+/// the size threshold below which it is used.
+
+#pragma once
+
+#include <hpx/kokkos/detail/future_origin.hpp>
+#include <hpx/kokkos/detail/graph_capture.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+#include <hpx/kokkos/detail/thread_pool_binding.hpp>
+#include <hpx/kokkos/executors.hpp>
+#include <hpx/kokkos/kokkos_algorithms.hpp>
+#include <hpx/kokkos/policy.hpp>
+
+#include <hpx/chrono.hpp>
+#include <hpx/future.hpp>
+#include <hpx/mutex.hpp>
+#include <hpx/runtime.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+/// Holds the threshold used by policies without their own threshold. Until
+/// the threshold has been set or calibrated nothing runs inline.
+class inline_threshold_state {
+public:
+  static inline_threshold_state &get() {
+    static inline_threshold_state s;
+    return s;
+  }
+
+  std::size_t threshold() const {
+    auto const t = threshold_.load(std::memory_order_relaxed);
+    return t != default_inline_threshold ? t : 0;
+  }
+
+  void set_threshold(std::size_t t) {
+    threshold_.store(t, std::memory_order_relaxed);
+  }
+
+  /// Sets the threshold to the number of iterations of a reference loop that
+  /// run inline in an eighth of the time of launching an empty kernel on the
+  /// default host execution space and waiting for its future. The factor
+  /// accounts for kernels doing more work per iteration than the reference
+  /// loop. Kokkos must be initialized. This blocks for several launches, so
+  /// it is only done when requested and never on the launch path.
+  std::size_t calibrate() {
+    if (!Kokkos::is_initialized()) {
+      throw std::runtime_error(
+          "calibrate_inline_threshold: Kokkos must be initialized");
+    }
+
+    std::lock_guard<hpx::mutex> l(mutex);
+
+    std::uint64_t launch = std::uint64_t(-1);
+    for (int r = 0; r < 8; ++r) {
+      auto const start = hpx::chrono::high_resolution_clock::now();
+      parallel_for_async(
+          "hpx::kokkos::calibrate_inline_threshold",
+          Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, 1),
+          KOKKOS_LAMBDA(int){})
+          .get();
+      launch = (std::min)(launch,
+                          hpx::chrono::high_resolution_clock::now() - start);
+    }
+
+    std::size_t const n = 4096;
+    std::vector<double> v(n, 1.0);
+    auto const start = hpx::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+      v[i] = v[i] * 0.5 + double(i);
+    }
+    auto const loop = (std::max)(
+        hpx::chrono::high_resolution_clock::now() - start, std::uint64_t(1));
+    // Keeps the reference loop from being optimized away
+    volatile double sink = v[n / 2];
+    (void)sink;
+
+    std::size_t const calibrated = (std::min)(
+        std::size_t(double(launch) / 8 / (double(loop) / n)), max_threshold);
+    HPX_KOKKOS_DETAIL_LOG("calibrated inline threshold %zu (launch %llu ns)",
+                          calibrated, (unsigned long long)launch);
+    threshold_.store(calibrated, std::memory_order_relaxed);
+    return calibrated;
+  }
+
+  /// The largest calibrated threshold.
+  static constexpr std::size_t max_threshold = 4096;
+
+private:
+  inline_threshold_state() = default;
+
+  std::atomic<std::size_t> threshold_{default_inline_threshold};
+  hpx::mutex mutex;
+};
+
+/// Whether all work submitted to an instance has completed. Launches on host
+/// execution spaces other than HPX complete before returning. For HPX the
+/// most recent future recorded for the instance is checked, which needs no
+/// allocation, unlike getting a new future from the instance. Only launches
+/// through this library are recorded, starting with the first check, and an
+/// instance without a recorded future is treated as busy, so it runs inline
+/// only after its first launch following the first check.
+template <typename ExecutionSpace> struct instance_idle {
+  static bool call(ExecutionSpace const &) { return true; }
+};
+
+#if defined(KOKKOS_ENABLE_HPX)
+template <> struct instance_idle<Kokkos::Experimental::HPX> {
+  static bool call(Kokkos::Experimental::HPX const &inst) {
+    return future_origins<Kokkos::Experimental::HPX>::get().last_ready(
+        instance_key<Kokkos::Experimental::HPX>::call(inst));
+  }
+};
+#endif
+
+/// Whether n iterations may run inline on the calling thread instead of on
+/// exec. Only executors with a single instance of a host execution space can
+/// run inline, and only while their instance is idle, not capturing a graph,
+/// and not bound to a thread pool the calling thread is not part of, so that
+/// the order of launches on the instance is kept.
+template <typename Executor>
+bool run_inline(Executor const &, std::size_t, std::size_t) {
+  return false;
+}
+
+template <typename ExecutionSpace>
+bool run_inline(executor<ExecutionSpace> const &exec, std::size_t n,
+                std::size_t threshold) {
+  using memory_space = typename ExecutionSpace::memory_space;
+  if (!Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                                  memory_space>::accessible) {
+    return false;
+  }
+  if (threshold == default_inline_threshold) {
+    threshold = inline_threshold_state::get().threshold();
+  }
+  if (n > threshold) {
+    return false;
+  }
+
+  auto const inst = exec.instance();
+  auto const *binding = find_thread_pool_binding(inst);
+  return graph_capture<ExecutionSpace>::capturing(inst) == nullptr &&
+         (binding == nullptr || binding->contains_current_thread()) &&
+         instance_idle<ExecutionSpace>::call(inst);
+}
+
+/// Calls f inline and returns a ready future with its result, or with the
+/// exception it threw, if the n iterations of the algorithm with policy may
+/// run inline, and otherwise calls launch and returns its future.
+template <typename ExecutionPolicy, typename F, typename Launch>
+auto launch_or_run_inline(ExecutionPolicy const &policy, std::size_t n, F &&f,
+                          Launch &&launch) -> decltype(launch()) {
+  using future_type = decltype(launch());
+  if (!run_inline(policy.executor(), n, policy.inline_threshold())) {
+    return launch();
+  }
+
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH("running %zu iterations of %s inline", n,
+                               policy.label());
+  using result_type = decltype(f());
+  try {
+    if constexpr (std::is_void<result_type>::value) {
+      f();
+      return future_type(hpx::make_ready_future());
+    } else {
+      return future_type(hpx::make_ready_future(f()));
+    }
+  } catch (...) {
+    // Exceptions are returned in the future, as from a kernel
+    return future_type(
+        hpx::make_exceptional_future<result_type>(std::current_exception()));
+  }
+}
+} // namespace detail
+
+/// Sets the threshold used by policies without their own threshold (see
+/// kokkos_policy::inline_threshold). Ranges with at most threshold iterations
+/// run inline on the calling thread. Zero disables running inline. The
+/// threshold can also be set at startup with
+/// --hpx:ini=hpx.kokkos.inline_threshold=<threshold>.
+inline void set_inline_threshold(std::size_t threshold) {
+  detail::inline_threshold_state::get().set_threshold(threshold);
+}
+
+/// Returns the threshold used by policies without their own threshold, or 0 if
+/// it has neither been set nor calibrated.
+inline std::size_t get_inline_threshold() {
+  return detail::inline_threshold_state::get().threshold();
+}
+
+/// Calibrates the threshold used by policies without their own threshold and
+/// returns it. Kokkos must be initialized. Calibration launches several
+/// kernels and waits for them, so it should be called once after
+/// initializing Kokkos rather than on a latency-sensitive path.
+inline std::size_t calibrate_inline_threshold() {
+  return detail::inline_threshold_state::get().calibrate();
+}
+
+namespace detail {
+inline void register_inline_threshold() {
+  std::string const threshold =
+      hpx::get_config_entry("hpx.kokkos.inline_threshold", "");
+  if (!threshold.empty()) {
+    set_inline_threshold(std::stoul(threshold));
+  }
+}
+
+struct inline_threshold_registration {
+  inline_threshold_registration() {
+    hpx::register_pre_startup_function(&register_inline_threshold);
+  }
+};
+
+inline inline_threshold_registration const
+    inline_threshold_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -12,11 +12,16 @@
 #include <hpx/kokkos/execution_spaces.hpp>
 #include <hpx/kokkos/executors.hpp>
 #include <hpx/kokkos/make_instance.hpp>
+#include <hpx/kokkos/partitioning_executor.hpp>
 
 #include <hpx/runtime.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 namespace hpx {
 namespace kokkos {
 template <typename ExecutionSpace = Kokkos::DefaultExecutionSpace>
@@ -51,6 +56,20 @@ public:
     return executor<execution_space>(get_execution_space(thread_num));
   }
 
+  /// Returns an executor splitting ranges over the next num_instances
+  /// instances of thread_num.
+  partitioning_executor<execution_space> get_partitioning_executor(
+      std::size_t const num_instances,
+      std::size_t const thread_num = hpx::get_worker_thread_num()) {
+    std::vector<execution_space> partition_instances;
+    partition_instances.reserve(num_instances);
+    for (std::size_t i = 0; i < num_instances; ++i) {
+      partition_instances.push_back(get_execution_space(thread_num));
+    }
+    return partitioning_executor<execution_space>(
+        std::move(partition_instances));
+  }
+
 private:
   std::size_t const num_instances_per_thread = 10;
   std::size_t const num_threads = hpx::get_num_worker_threads();
@@ -0,0 +1,382 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains instrumentation of the asynchronous launches in this library and
+/// the HPX performance counters exposing it.
+
+#pragma once
+
+#include <hpx/kokkos/detail/future_origin.hpp>
+#include <hpx/kokkos/execution_spaces.hpp>
+#include <hpx/kokkos/trace.hpp>
+
+#include <hpx/chrono.hpp>
+#include <hpx/config.hpp>
+#include <hpx/future.hpp>
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+#include <hpx/include/performance_counters.hpp>
+#endif
+#include <hpx/runtime.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// Statistics of the launches with a given label. Times are in nanoseconds.
+struct kernel_statistics {
+  std::uint64_t launched = 0;
+  std::uint64_t completed = 0;
+  std::uint64_t enqueue_time = 0;
+  std::uint64_t completion_time = 0;
+};
+
+namespace detail {
+struct label_counters {
+  std::atomic<std::uint64_t> launched{0};
+  std::atomic<std::uint64_t> completed{0};
+  std::atomic<std::uint64_t> enqueue_time{0};
+  std::atomic<std::uint64_t> completion_time{0};
+};
+
+struct label_entry {
+  explicit label_entry(std::string_view l) : label(l) {}
+
+  std::string const label;
+  label_counters counters;
+};
+
+/// Accumulates statistics of launches. Per-label counters live in an
+/// insert-only hash table that is looked up without locks, so that concurrent
+/// launches do not serialize, and completions update them without a lookup.
+class instrumentation {
+public:
+  /// The number of instances that get separate in-flight counters. Further
+  /// instances share the last one.
+  static constexpr std::size_t max_instances = 64;
+  /// The number of labels that get separate counters. Launches with further
+  /// labels are only counted in the totals.
+  static constexpr std::size_t max_labels = 4096;
+
+  static instrumentation &get() {
+    static instrumentation i;
+    return i;
+  }
+
+  ~instrumentation() {
+    for (auto &slot : labels) {
+      delete slot.load(std::memory_order_relaxed);
+    }
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void enable(bool e) { enabled_.store(e, std::memory_order_relaxed); }
+
+  /// Returns the counters of label, or nullptr if there are too many labels.
+  label_counters *counters_for(char const *label) {
+    std::string_view const l(label);
+    auto const hash = std::hash<std::string_view>{}(l);
+    for (std::size_t probe = 0; probe < max_labels; ++probe) {
+      auto &slot = labels[(hash + probe) % max_labels];
+      label_entry *e = slot.load(std::memory_order_acquire);
+      if (e == nullptr) {
+        auto *created = new label_entry(l);
+        if (slot.compare_exchange_strong(e, created,
+                                         std::memory_order_acq_rel)) {
+          return &created->counters;
+        }
+        delete created;
+      }
+      if (e->label == l) {
+        return &e->counters;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Assigns the next in-flight counter to a new instance.
+  std::size_t next_instance_index() {
+    return std::min(instances.fetch_add(1, std::memory_order_relaxed),
+                    max_instances - 1);
+  }
+
+  void launched(label_counters *c, std::size_t instance,
+                std::uint64_t enqueue_time) {
+    if (c != nullptr) {
+      c->launched.fetch_add(1, std::memory_order_relaxed);
+      c->enqueue_time.fetch_add(enqueue_time, std::memory_order_relaxed);
+    }
+    total.launched.fetch_add(1, std::memory_order_relaxed);
+    total.enqueue_time.fetch_add(enqueue_time, std::memory_order_relaxed);
+    inflight[instance].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void completed(label_counters *c, std::size_t instance,
+                 std::uint64_t completion_time) {
+    inflight[instance].fetch_sub(1, std::memory_order_relaxed);
+    if (c != nullptr) {
+      c->completed.fetch_add(1, std::memory_order_relaxed);
+      c->completion_time.fetch_add(completion_time,
+                                   std::memory_order_relaxed);
+    }
+    total.completed.fetch_add(1, std::memory_order_relaxed);
+    total.completion_time.fetch_add(completion_time,
+                                    std::memory_order_relaxed);
+  }
+
+  static kernel_statistics snapshot(label_counters const &c) {
+    kernel_statistics s;
+    s.launched = c.launched.load(std::memory_order_relaxed);
+    s.completed = c.completed.load(std::memory_order_relaxed);
+    s.enqueue_time = c.enqueue_time.load(std::memory_order_relaxed);
+    s.completion_time = c.completion_time.load(std::memory_order_relaxed);
+    return s;
+  }
+
+  std::map<std::string, kernel_statistics> label_statistics() const {
+    std::map<std::string, kernel_statistics> s;
+    for (auto const &slot : labels) {
+      if (auto const *e = slot.load(std::memory_order_acquire)) {
+        s.emplace(e->label, snapshot(e->counters));
+      }
+    }
+    return s;
+  }
+
+  label_counters total;
+  std::array<std::atomic<std::int64_t>, max_instances> inflight{};
+
+private:
+  instrumentation() = default;
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<std::size_t> instances{0};
+  std::array<std::atomic<label_entry *>, max_labels> labels{};
+};
+
+/// Maps the instances of ExecutionSpace to their in-flight counters. Like the
+/// labels, instances are kept in an insert-only hash table looked up without
+/// locks. Instances beyond the capacity share the last counter.
+template <typename ExecutionSpace> class instance_indices {
+public:
+  static std::size_t get(std::uintptr_t key) {
+    static instance_indices indices;
+    return indices.index(key);
+  }
+
+private:
+  static constexpr std::size_t capacity = 2 * instrumentation::max_instances;
+  static constexpr std::size_t unassigned = ~std::size_t(0);
+
+  struct entry {
+    // Keys are stored plus one, so that zero marks an empty entry
+    std::atomic<std::uintptr_t> key{0};
+    std::atomic<std::size_t> index{unassigned};
+  };
+
+  std::size_t index(std::uintptr_t key) {
+    auto const stored = key + 1;
+    for (std::size_t probe = 0; probe < capacity; ++probe) {
+      auto &e = entries[(std::hash<std::uintptr_t>{}(key) + probe) % capacity];
+      std::uintptr_t k = e.key.load(std::memory_order_acquire);
+      if (k == 0 && e.key.compare_exchange_strong(k, stored,
+                                                  std::memory_order_acq_rel)) {
+        auto const i = instrumentation::get().next_instance_index();
+        e.index.store(i, std::memory_order_release);
+        return i;
+      }
+      if (k == stored) {
+        // The thread that inserted the key assigns the index right after
+        std::size_t i;
+        while ((i = e.index.load(std::memory_order_acquire)) == unassigned) {
+        }
+        return i;
+      }
+    }
+    return instrumentation::max_instances - 1;
+  }
+
+  std::array<entry, capacity> entries{};
+};
+
+template <typename ExecutionSpace>
+std::uintptr_t instrumentation_key_impl(std::true_type,
+                                        ExecutionSpace const &inst) {
+  return instance_key<ExecutionSpace>::call(inst);
+}
+
+template <typename ExecutionSpace>
+std::uintptr_t instrumentation_key_impl(std::false_type,
+                                        ExecutionSpace const &) {
+  return 0;
+}
+
+/// Calls launch, which submits work to inst and returns a future for it. When
+/// instrumentation is enabled the time taken by launch and the time until the
+/// returned future becomes ready are recorded under label. When tracing is
+/// enabled the launch and the future becoming ready are traced.
+template <typename ExecutionSpace, typename F>
+hpx::shared_future<void> instrumented(ExecutionSpace const &inst,
+                                      char const *label, F &&launch) {
+  auto &i = instrumentation::get();
+  auto &t = tracer::get();
+  bool const count = i.enabled();
+  bool const trace = t.enabled();
+  if (!count && !trace) {
+    return launch();
+  }
+
+  label_counters *c = count ? i.counters_for(label) : nullptr;
+  auto const instance = instance_indices<ExecutionSpace>::get(
+      instrumentation_key_impl(is_execution_space_in_order<ExecutionSpace>{},
+                               inst));
+
+  auto const start = hpx::chrono::high_resolution_clock::now();
+  auto f = [&] {
+    tools_launch_region region(trace, label);
+    return launch();
+  }();
+  auto const end = hpx::chrono::high_resolution_clock::now();
+
+  if (count) {
+    i.launched(c, instance, end - start);
+  }
+  std::uint64_t const id =
+      trace ? t.launched(label, instance, start, end) : 0;
+
+  f.then(hpx::launch::sync,
+         [&i, &t, count, c, id, instance, start,
+          name = trace ? std::string(label) : std::string()](auto &&) {
+           auto const now = hpx::chrono::high_resolution_clock::now();
+           if (count) {
+             i.completed(c, instance, now - start);
+           }
+           if (id != 0) {
+             t.ready(id, name.c_str(), instance, now);
+           }
+         });
+  return f;
+}
+
+inline std::int64_t read_counter(std::atomic<std::uint64_t> const &v) {
+  return static_cast<std::int64_t>(v.load(std::memory_order_relaxed));
+}
+
+inline std::int64_t average(std::atomic<std::uint64_t> const &sum,
+                            std::atomic<std::uint64_t> const &count) {
+  auto const n = count.load(std::memory_order_relaxed);
+  return n == 0 ? 0
+                : static_cast<std::int64_t>(
+                      sum.load(std::memory_order_relaxed) / n);
+}
+} // namespace detail
+
+/// Enables or disables instrumentation of launches. Instrumentation is
+/// disabled by default, and can also be enabled at startup with
+/// --hpx:ini=hpx.kokkos.instrumentation=1.
+inline void enable_instrumentation(bool enable = true) {
+  detail::instrumentation::get().enable(enable);
+}
+
+/// Returns the statistics of all launches with the given label so far.
+inline kernel_statistics get_kernel_statistics(std::string const &label) {
+  return detail::instrumentation::get().label_statistics()[label];
+}
+
+/// Returns the statistics of all launches so far, by label.
+inline std::map<std::string, kernel_statistics> get_kernel_statistics() {
+  return detail::instrumentation::get().label_statistics();
+}
+
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+/// Installs the HPX performance counters of this library. This is done
+/// automatically at startup of the HPX runtime. The counters are cumulative
+/// and are not reset. Performance counters are only available when HPX is
+/// built with the distributed runtime.
+inline void register_performance_counters() {
+  using hpx::performance_counters::install_counter_type;
+  auto &i = detail::instrumentation::get();
+
+  install_counter_type(
+      "/hpx-kokkos/kernels/launched",
+      [&i](bool) { return detail::read_counter(i.total.launched); },
+      "returns the number of kernels and copies launched");
+  install_counter_type(
+      "/hpx-kokkos/kernels/completed",
+      [&i](bool) { return detail::read_counter(i.total.completed); },
+      "returns the number of kernels and copies completed");
+  install_counter_type(
+      "/hpx-kokkos/kernels/inflight",
+      [&i](bool) {
+        std::int64_t n = 0;
+        for (auto const &c : i.inflight) {
+          n += c.load(std::memory_order_relaxed);
+        }
+        return n;
+      },
+      "returns the number of kernels and copies launched but not yet "
+      "completed");
+  install_counter_type(
+      "/hpx-kokkos/kernels/time/average-enqueue",
+      [&i](bool) {
+        return detail::average(i.total.enqueue_time, i.total.launched);
+      },
+      "returns the average time taken to enqueue a kernel or copy", "ns");
+  install_counter_type(
+      "/hpx-kokkos/kernels/time/average-completion",
+      [&i](bool) {
+        return detail::average(i.total.completion_time, i.total.completed);
+      },
+      "returns the average time from launching a kernel or copy until its "
+      "future is ready",
+      "ns");
+  install_counter_type(
+      "/hpx-kokkos/instances/inflight",
+      [&i](bool) {
+        std::vector<std::int64_t> n;
+        n.reserve(i.inflight.size());
+        for (auto const &c : i.inflight) {
+          n.push_back(c.load(std::memory_order_relaxed));
+        }
+        return n;
+      },
+      "returns the number of kernels and copies in flight on each execution "
+      "space instance, in the order the instances were first used");
+}
+#endif
+
+namespace detail {
+inline void register_instrumentation() {
+  if (hpx::get_config_entry("hpx.kokkos.instrumentation", "0") != "0") {
+    instrumentation::get().enable(true);
+  }
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+  register_performance_counters();
+#endif
+}
+
+struct instrumentation_registration {
+  instrumentation_registration() {
+    hpx::register_pre_startup_function(&register_instrumentation);
+  }
+};
+
+inline instrumentation_registration const
+    instrumentation_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <hpx/kokkos/dependencies.hpp>
+#include <hpx/kokkos/detail/dispatch.hpp>
 #include <hpx/kokkos/detail/logging.hpp>
 #include <hpx/kokkos/future.hpp>
 
@@ -14,38 +16,65 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 namespace hpx {
 namespace kokkos {
+namespace detail {
+struct parallel_for_fn {
+  template <typename... Args> void operator()(Args &&...args) const {
+    Kokkos::parallel_for(std::forward<Args>(args)...);
+  }
+};
+
+struct parallel_reduce_fn {
+  template <typename... Args> void operator()(Args &&...args) const {
+    Kokkos::parallel_reduce(std::forward<Args>(args)...);
+  }
+};
+
+struct parallel_scan_fn {
+  template <typename... Args> void operator()(Args &&...args) const {
+    Kokkos::parallel_scan(std::forward<Args>(args)...);
+  }
+};
+} // namespace detail
+
 // Asynchronous versions of Kokkos algorithms
 template <typename ExecutionPolicy, typename... Args,
           typename Enable = typename std::enable_if<Kokkos::is_execution_policy<
               typename std::decay<ExecutionPolicy>::type>::value>::type>
 hpx::shared_future<void> parallel_for_async(ExecutionPolicy &&policy,
                                             Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG("calling parallel_for_async with execution policy");
-  Kokkos::parallel_for(policy, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<decltype(
-      policy.space())>::type>::call(policy.space());
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_for_async with execution policy");
+  return detail::dispatch(policy.space(), "parallel_for",
+                          detail::parallel_for_fn{}, policy,
+                          std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 hpx::shared_future<void> parallel_for_async(std::size_t const work_count,
                                             Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG("calling parallel_for_async without execution policy");
-  Kokkos::parallel_for(work_count, std::forward<Args>(args)...);
-  return detail::get_future<Kokkos::DefaultExecutionSpace>::call(
-      Kokkos::DefaultExecutionSpace{});
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_for_async without execution policy");
+  return detail::dispatch(Kokkos::DefaultExecutionSpace{}, "parallel_for",
+                          detail::parallel_for_fn{}, work_count,
+                          std::forward<Args>(args)...);
 }
 
 template <typename ExecutionPolicy, typename... Args>
 hpx::shared_future<void> parallel_for_async(std::string const &label,
                                             ExecutionPolicy &&policy,
                                             Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG(
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
       "calling parallel_for_async with label and execution policy");
-  Kokkos::parallel_for(label, policy, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<decltype(
-      policy.space())>::type>::call(policy.space());
+  return detail::dispatch(policy.space(), label.c_str(),
+                          detail::parallel_for_fn{}, label, policy,
+                          std::forward<Args>(args)...);
 }
 
 template <typename ExecutionPolicy, typename... Args,
@@ -53,31 +82,32 @@ template <typename ExecutionPolicy, typename... Args,
               Kokkos::is_execution_policy<ExecutionPolicy>::value>::type>
 hpx::shared_future<void> parallel_reduce_async(ExecutionPolicy &&policy,
                                                Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG("calling parallel_reduce_async with execution policy");
-  Kokkos::parallel_reduce(policy, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<decltype(
-      policy.space())>::type>::call(policy.space());
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_reduce_async with execution policy");
+  return detail::dispatch(policy.space(), "parallel_reduce",
+                          detail::parallel_reduce_fn{}, policy,
+                          std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 hpx::shared_future<void> parallel_reduce_async(std::size_t const work_count,
                                                Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG(
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
       "calling parallel_reduce_async without execution policy");
-  Kokkos::parallel_reduce(work_count, std::forward<Args>(args)...);
-  return detail::get_future<Kokkos::DefaultExecutionSpace>::call(
-      Kokkos::DefaultExecutionSpace{});
+  return detail::dispatch(Kokkos::DefaultExecutionSpace{}, "parallel_reduce",
+                          detail::parallel_reduce_fn{}, work_count,
+                          std::forward<Args>(args)...);
 }
 
 template <typename ExecutionPolicy, typename... Args>
 hpx::shared_future<void> parallel_reduce_async(std::string const &label,
                                                ExecutionPolicy &&policy,
                                                Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG(
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
       "calling parallel_reduce_async with label and execution policy");
-  Kokkos::parallel_reduce(label, policy, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<decltype(
-      policy.space())>::type>::call(policy.space());
+  return detail::dispatch(policy.space(), label.c_str(),
+                          detail::parallel_reduce_fn{}, label, policy,
+                          std::forward<Args>(args)...);
 }
 
 template <typename ExecutionPolicy, typename... Args,
@@ -85,30 +115,179 @@ template <typename ExecutionPolicy, typename... Args,
               Kokkos::is_execution_policy<ExecutionPolicy>::value>::type>
 hpx::shared_future<void> parallel_scan_async(ExecutionPolicy &&policy,
                                              Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG("calling parallel_scan_async with execution policy");
-  Kokkos::parallel_scan(policy, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<decltype(
-      policy.space())>::type>::call(policy.space());
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_scan_async with execution policy");
+  return detail::dispatch(policy.space(), "parallel_scan",
+                          detail::parallel_scan_fn{}, policy,
+                          std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 hpx::shared_future<void> parallel_scan_async(std::size_t const work_count,
                                              Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG("calling parallel_scan_async without execution policy");
-  Kokkos::parallel_scan(work_count, std::forward<Args>(args)...);
-  return detail::get_future<Kokkos::DefaultExecutionSpace>::call(
-      Kokkos::DefaultExecutionSpace{});
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_scan_async without execution policy");
+  return detail::dispatch(Kokkos::DefaultExecutionSpace{}, "parallel_scan",
+                          detail::parallel_scan_fn{}, work_count,
+                          std::forward<Args>(args)...);
 }
 
 template <typename ExecutionPolicy, typename... Args>
 hpx::shared_future<void> parallel_scan_async(std::string const &label,
                                              ExecutionPolicy &&policy,
                                              Args &&...args) {
-  HPX_KOKKOS_DETAIL_LOG(
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
       "calling parallel_scan_async with label and execution policy");
-  Kokkos::parallel_scan(label, policy, std::forward<Args>(args)...);
-  return detail::get_future<typename std::decay<decltype(
-      policy.space())>::type>::call(policy.space());
+  return detail::dispatch(policy.space(), label.c_str(),
+                          detail::parallel_scan_fn{}, label, policy,
+                          std::forward<Args>(args)...);
+}
+
+// Asynchronous versions of Kokkos algorithms that are launched once the given
+// dependencies are ready. The dependencies are waited for without blocking an
+// HPX thread.
+template <typename Dependencies, typename ExecutionPolicy, typename... Args,
+          typename Enable = typename std::enable_if<
+              is_dependency<typename std::decay<Dependencies>::type>::value &&
+              Kokkos::is_execution_policy<
+                  typename std::decay<ExecutionPolicy>::type>::value>::type>
+hpx::shared_future<void> parallel_for_async(Dependencies &&deps,
+                                            ExecutionPolicy &&policy,
+                                            Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_for_async with dependencies and execution policy");
+  using policy_type = typename std::decay<ExecutionPolicy>::type;
+  auto const space = policy.space();
+  return detail::launch_after(
+      space, std::forward<Dependencies>(deps),
+      [policy = policy_type(std::forward<ExecutionPolicy>(policy)),
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return parallel_for_async(policy_type(policy), captured...);
+            },
+            pack);
+      });
+}
+
+template <typename Dependencies, typename ExecutionPolicy, typename... Args,
+          typename Enable = typename std::enable_if<is_dependency<
+              typename std::decay<Dependencies>::type>::value>::type>
+hpx::shared_future<void> parallel_for_async(Dependencies &&deps,
+                                            std::string const &label,
+                                            ExecutionPolicy &&policy,
+                                            Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_for_async with dependencies, label and execution policy");
+  using policy_type = typename std::decay<ExecutionPolicy>::type;
+  auto const space = policy.space();
+  return detail::launch_after(
+      space, std::forward<Dependencies>(deps),
+      [label, policy = policy_type(std::forward<ExecutionPolicy>(policy)),
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return parallel_for_async(label, policy_type(policy),
+                                        captured...);
+            },
+            pack);
+      });
+}
+
+template <typename Dependencies, typename ExecutionPolicy, typename... Args,
+          typename Enable = typename std::enable_if<
+              is_dependency<typename std::decay<Dependencies>::type>::value &&
+              Kokkos::is_execution_policy<
+                  typename std::decay<ExecutionPolicy>::type>::value>::type>
+hpx::shared_future<void> parallel_reduce_async(Dependencies &&deps,
+                                               ExecutionPolicy &&policy,
+                                               Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_reduce_async with dependencies and execution policy");
+  using policy_type = typename std::decay<ExecutionPolicy>::type;
+  auto const space = policy.space();
+  return detail::launch_after(
+      space, std::forward<Dependencies>(deps),
+      [policy = policy_type(std::forward<ExecutionPolicy>(policy)),
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return parallel_reduce_async(policy_type(policy), captured...);
+            },
+            pack);
+      });
+}
+
+template <typename Dependencies, typename ExecutionPolicy, typename... Args,
+          typename Enable = typename std::enable_if<is_dependency<
+              typename std::decay<Dependencies>::type>::value>::type>
+hpx::shared_future<void> parallel_reduce_async(Dependencies &&deps,
+                                               std::string const &label,
+                                               ExecutionPolicy &&policy,
+                                               Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_reduce_async with dependencies, label and execution policy");
+  using policy_type = typename std::decay<ExecutionPolicy>::type;
+  auto const space = policy.space();
+  return detail::launch_after(
+      space, std::forward<Dependencies>(deps),
+      [label, policy = policy_type(std::forward<ExecutionPolicy>(policy)),
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return parallel_reduce_async(label, policy_type(policy),
+                                           captured...);
+            },
+            pack);
+      });
+}
+
+template <typename Dependencies, typename ExecutionPolicy, typename... Args,
+          typename Enable = typename std::enable_if<
+              is_dependency<typename std::decay<Dependencies>::type>::value &&
+              Kokkos::is_execution_policy<
+                  typename std::decay<ExecutionPolicy>::type>::value>::type>
+hpx::shared_future<void> parallel_scan_async(Dependencies &&deps,
+                                             ExecutionPolicy &&policy,
+                                             Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_scan_async with dependencies and execution policy");
+  using policy_type = typename std::decay<ExecutionPolicy>::type;
+  auto const space = policy.space();
+  return detail::launch_after(
+      space, std::forward<Dependencies>(deps),
+      [policy = policy_type(std::forward<ExecutionPolicy>(policy)),
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return parallel_scan_async(policy_type(policy), captured...);
+            },
+            pack);
+      });
+}
+
+template <typename Dependencies, typename ExecutionPolicy, typename... Args,
+          typename Enable = typename std::enable_if<is_dependency<
+              typename std::decay<Dependencies>::type>::value>::type>
+hpx::shared_future<void> parallel_scan_async(Dependencies &&deps,
+                                             std::string const &label,
+                                             ExecutionPolicy &&policy,
+                                             Args &&...args) {
+  HPX_KOKKOS_DETAIL_LOG_LAUNCH(
+      "calling parallel_scan_async with dependencies, label and execution policy");
+  using policy_type = typename std::decay<ExecutionPolicy>::type;
+  auto const space = policy.space();
+  return detail::launch_after(
+      space, std::forward<Dependencies>(deps),
+      [label, policy = policy_type(std::forward<ExecutionPolicy>(policy)),
+       pack = detail::capture_args(std::forward<Args>(args)...)]() mutable {
+        return std::apply(
+            [&](auto &...captured) {
+              return parallel_scan_async(label, policy_type(policy),
+                                         captured...);
+            },
+            pack);
+      });
 }
 } // namespace kokkos
 } // namespace hpx
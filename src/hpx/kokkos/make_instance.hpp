@@ -4,15 +4,18 @@
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 /// \file
-/// Contains a helper for creating thread-local execution space instances and
-/// executors.
+/// Contains factories for independent execution space instances.
 
 #pragma once
 
+#include <hpx/kokkos/detail/thread_pool_binding.hpp>
 #include <hpx/kokkos/execution_spaces.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
+#include <string>
+
 namespace hpx {
 namespace kokkos {
 namespace detail {
@@ -73,6 +76,42 @@ make_independent_execution_space_instance<Kokkos::Experimental::HPX>() {
   return Kokkos::Experimental::HPX(Kokkos::Experimental::HPX::instance_mode::independent);
 }
 #endif
+
+/// Creates an independent instance bound to a thread pool as given by binding.
+/// Only HPX instances can be bound; other execution spaces ignore the binding.
+template <typename ExecutionSpace>
+ExecutionSpace
+make_bound_execution_space_instance(thread_pool_binding const &) {
+  return make_independent_execution_space_instance<ExecutionSpace>();
+}
+
+#if defined(KOKKOS_ENABLE_HPX)
+template <>
+inline Kokkos::Experimental::HPX
+make_bound_execution_space_instance<Kokkos::Experimental::HPX>(
+    thread_pool_binding const &binding) {
+  auto inst =
+      make_independent_execution_space_instance<Kokkos::Experimental::HPX>();
+  thread_pool_bindings::get().bind(inst.impl_instance_id(), binding);
+  return inst;
+}
+#endif
 } // namespace detail
+
+/// \brief Creates an independent instance of ExecutionSpace whose kernels run
+/// on the HPX thread pool named pool (the default pool if empty), using at
+/// most concurrency workers of the pool per kernel (no limit if 0).
+///
+/// Only HPX instances can be bound to a pool. The concurrency limit applies to
+/// range policies. Other execution spaces return an unbound independent
+/// instance.
+template <typename ExecutionSpace>
+ExecutionSpace
+make_independent_execution_space_instance(std::string const &pool,
+                                          std::size_t concurrency = 0) {
+  return detail::make_bound_execution_space_instance<ExecutionSpace>(
+      detail::thread_pool_binding{&detail::get_bound_thread_pool(pool),
+                                  concurrency});
+}
 } // namespace kokkos
 } // namespace hpx
@@ -0,0 +1,233 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains NUMA-aware execution space instances, executors, and view
+/// allocation. One HPX thread pool is created per NUMA domain with the
+/// resource partitioner, and instances are bound to the pool of their domain,
+/// so that all tasks of their kernels run on that domain. Views are
+/// initialized in blocks by the instance of the domain that later works on the
+/// block, so that their pages are placed on that domain on first touch.
+
+#pragma once
+
+#include <hpx/kokkos/deep_copy.hpp>
+#include <hpx/kokkos/detail/thread_pool_binding.hpp>
+#include <hpx/kokkos/executors.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/make_instance.hpp>
+#include <hpx/kokkos/partitioning_executor.hpp>
+
+#include <hpx/future.hpp>
+#include <hpx/include/resource_partitioner.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/runtime.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// The default prefix of the names of the thread pools created by
+/// create_numa_thread_pools.
+inline constexpr char const *default_numa_thread_pool_prefix = "numa-";
+
+/// Creates one HPX thread pool per NUMA domain with rp and adds the processing
+/// units of the domain to it. The pools are named prefix followed by 0, 1,
+/// and so on. The first processing unit is left to the default pool, which
+/// can not be empty, and domains left without processing units are skipped.
+/// Must be called from the resource partitioner callback passed to hpx::init,
+/// e.g. through hpx::init_params::rp_callback.
+inline void create_numa_thread_pools(
+    hpx::resource::partitioner &rp,
+    std::string const &prefix = default_numa_thread_pool_prefix) {
+  bool first = true;
+  std::size_t index = 0;
+  for (auto const &domain : rp.numa_domains()) {
+    std::string const name = prefix + std::to_string(index);
+    bool created = false;
+    for (auto const &core : domain.cores()) {
+      for (auto const &pu : core.pus()) {
+        if (first) {
+          first = false;
+          continue;
+        }
+        if (!created) {
+          rp.create_thread_pool(name);
+          created = true;
+        }
+        rp.add_resource(pu, name);
+      }
+    }
+    if (created) {
+      ++index;
+    }
+  }
+}
+
+namespace detail {
+/// Returns the pools created by create_numa_thread_pools with prefix, in the
+/// order of their domains.
+inline std::vector<hpx::threads::thread_pool_base *>
+get_numa_thread_pools(std::string const &prefix) {
+  std::vector<hpx::threads::thread_pool_base *> pools;
+  for (std::size_t d = 0;
+       hpx::resource::pool_exists(prefix + std::to_string(d)); ++d) {
+    pools.push_back(
+        &hpx::resource::get_thread_pool(prefix + std::to_string(d)));
+  }
+  return pools;
+}
+} // namespace detail
+
+/// \brief HPX executor launching each block of a one-dimensional iteration
+/// range on the instance of one NUMA domain.
+///
+/// Ranges are split as by partitioning_executor, with one block per NUMA
+/// domain. Other launches use the instance of the NUMA domain of the calling
+/// thread.
+template <typename ExecutionSpace = Kokkos::DefaultHostExecutionSpace>
+class numa_executor : public partitioning_executor<ExecutionSpace> {
+  using base_type = partitioning_executor<ExecutionSpace>;
+
+public:
+  using execution_space = ExecutionSpace;
+
+  /// Creates an executor with one instance per thread pool created by
+  /// create_numa_thread_pools with prefix. See numa_instance_helper.
+  explicit numa_executor(
+      std::string const &prefix = default_numa_thread_pool_prefix);
+  /// Creates an executor with the given instances, one per NUMA domain.
+  explicit numa_executor(std::vector<execution_space> instances)
+      : base_type(std::move(instances)) {}
+
+  /// Returns the instance of the NUMA domain of the calling thread, or the
+  /// first instance if the calling thread is not on the pool of a domain.
+  execution_space instance() const {
+    for (auto const &inst : this->instances()) {
+      auto const *binding = detail::find_thread_pool_binding(inst);
+      if (binding != nullptr && binding->contains_current_thread()) {
+        return inst;
+      }
+    }
+    return base_type::instance();
+  }
+
+  numa_executor with_future_strategy(future_strategy s) const {
+    numa_executor exec = *this;
+    static_cast<base_type &>(exec) = base_type::with_future_strategy(s);
+    return exec;
+  }
+
+  template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    executor<execution_space>(instance())
+        .with_future_strategy(this->strategy())
+        .post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  template <typename F, typename... Ts>
+  hpx::shared_future<void> async_execute(F &&f, Ts &&...ts) {
+    return executor<execution_space>(instance())
+        .with_future_strategy(this->strategy())
+        .async_execute(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+};
+
+/// \brief Creates one independent instance per NUMA domain, bound to the
+/// thread pool of that domain.
+///
+/// The pools are those created by create_numa_thread_pools with prefix. The
+/// instances use at most as many workers per kernel as their pool has. If no
+/// such pools exist, a single instance bound to the default pool is created,
+/// and kernels run on any of its workers. Only HPX instances can be bound.
+/// Other execution spaces get one unbound independent instance per domain.
+template <typename ExecutionSpace = Kokkos::DefaultHostExecutionSpace>
+class numa_instance_helper {
+public:
+  using execution_space = ExecutionSpace;
+
+  explicit numa_instance_helper(
+      std::string const &prefix = default_numa_thread_pool_prefix) {
+    auto pools = detail::get_numa_thread_pools(prefix);
+    if (pools.empty()) {
+      pools.push_back(&hpx::resource::get_thread_pool(0));
+    }
+    for (auto *pool : pools) {
+      instances.push_back(
+          detail::make_bound_execution_space_instance<execution_space>(
+              detail::thread_pool_binding{pool,
+                                          pool->get_os_thread_count()}));
+    }
+  }
+
+  std::size_t num_domains() const { return instances.size(); }
+
+  execution_space const &get_execution_space(std::size_t domain) const {
+    return instances[domain];
+  }
+
+  executor<execution_space> get_executor(std::size_t domain) const {
+    return executor<execution_space>(instances[domain]);
+  }
+
+  numa_executor<execution_space> get_numa_executor() const {
+    return numa_executor<execution_space>(instances);
+  }
+
+private:
+  std::vector<execution_space> instances;
+};
+
+template <typename ExecutionSpace>
+numa_executor<ExecutionSpace>::numa_executor(std::string const &prefix)
+    : numa_executor(
+          numa_instance_helper<ExecutionSpace>(prefix).get_numa_executor()) {}
+
+/// Allocates a view and initializes it in blocks along its slowest-varying
+/// dimension, each block on one instance of exec, so that with a numa_executor
+/// the pages of each block are placed on the NUMA domain whose instance works
+/// on the same block of a one-dimensional range of the same extent. The view
+/// is ready to use when this returns. Placement relies on first touch, i.e.
+/// it applies to host memory spaces that allocate pages lazily.
+template <typename View, typename ExecutionSpace, typename... Extents>
+View make_first_touch_view(partitioning_executor<ExecutionSpace> const &exec,
+                           std::string const &label, Extents... extents) {
+  View v(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), extents...);
+
+  constexpr std::size_t dim = detail::chunk_dimension<View>::value;
+  std::size_t const chunks =
+      detail::effective_num_chunks(v.extent(dim), exec.size());
+  std::vector<hpx::shared_future<void>> futures;
+  futures.reserve(chunks);
+  for (std::size_t c = 0; c < chunks; ++c) {
+    futures.push_back(deep_copy_async(exec.instances()[c],
+                                      view_chunk(v, chunks, c),
+                                      typename View::value_type{}));
+  }
+  for (auto &f : futures) {
+    f.get();
+  }
+
+  return v;
+}
+
+template <typename ExecutionSpace>
+struct is_kokkos_executor<numa_executor<ExecutionSpace>> : std::true_type {};
+} // namespace kokkos
+} // namespace hpx
+
+namespace HPXKOKKOS_HPX_EXECUTOR_NS {
+template <typename ExecutionSpace>
+struct is_one_way_executor<hpx::kokkos::numa_executor<ExecutionSpace>>
+    : std::true_type {};
+
+template <typename ExecutionSpace>
+struct is_two_way_executor<hpx::kokkos::numa_executor<ExecutionSpace>>
+    : std::true_type {};
+} // namespace HPXKOKKOS_HPX_EXECUTOR_NS
@@ -0,0 +1,168 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains an executor that splits the iteration range of an algorithm into
+/// contiguous blocks and launches each block on a different execution space
+/// instance.
+
+#pragma once
+
+#include <hpx/kokkos/deep_copy.hpp>
+#include <hpx/kokkos/detail/partitioned_launch.hpp>
+#include <hpx/kokkos/executors.hpp>
+#include <hpx/kokkos/future_strategy.hpp>
+#include <hpx/kokkos/make_instance.hpp>
+
+#include <hpx/future.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// \brief HPX executor splitting one-dimensional iteration ranges into one
+/// contiguous block per instance and launching each block on its instance.
+///
+/// The ranges of hpx::for_each, hpx::experimental::for_loop, hpx::reduce, and
+/// hpx::transform are split in the same way as view_chunk splits a view. The
+/// algorithms return a single future for all blocks. Multi-dimensional ranges
+/// and other launches use the first instance.
+template <typename ExecutionSpace = Kokkos::DefaultExecutionSpace>
+class partitioning_executor {
+public:
+  using execution_space = ExecutionSpace;
+  using execution_category = hpx::execution::parallel_execution_tag;
+
+  /// Creates an executor with num_instances independent instances.
+  explicit partitioning_executor(std::size_t num_instances = 1) {
+    instances_.reserve(num_instances);
+    for (std::size_t i = 0; i < num_instances; ++i) {
+      instances_.push_back(
+          detail::make_independent_execution_space_instance<
+              execution_space>());
+    }
+    check_instances();
+  }
+  /// Creates an executor with the given instances.
+  explicit partitioning_executor(std::vector<execution_space> instances)
+      : instances_(std::move(instances)) {
+    check_instances();
+  }
+
+  execution_space instance() const { return instances_.front(); }
+  std::vector<execution_space> const &instances() const { return instances_; }
+  std::size_t size() const { return instances_.size(); }
+
+  /// Returns an executor for instance number i.
+  executor<execution_space> get_executor(std::size_t i) const {
+    return executor<execution_space>(instances_[i])
+        .with_future_strategy(strategy_);
+  }
+
+  partitioning_executor with_future_strategy(future_strategy s) const {
+    auto exec = *this;
+    exec.strategy_ = s;
+    return exec;
+  }
+  future_strategy strategy() const { return strategy_; }
+
+  template <typename F, typename... Ts> void post(F &&f, Ts &&...ts) {
+    executor<execution_space>(instance())
+        .with_future_strategy(strategy_)
+        .post(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  template <typename F, typename... Ts>
+  hpx::shared_future<void> async_execute(F &&f, Ts &&...ts) {
+    return executor<execution_space>(instance())
+        .with_future_strategy(strategy_)
+        .async_execute(std::forward<F>(f), std::forward<Ts>(ts)...);
+  }
+
+  /// Returns a future that becomes ready when all work submitted to the
+  /// instances so far has completed.
+  hpx::shared_future<void> get_future() {
+    std::vector<hpx::shared_future<void>> futures;
+    futures.reserve(instances_.size());
+    for (std::size_t i = 0; i < instances_.size(); ++i) {
+      futures.push_back(get_executor(i).get_future());
+    }
+    return detail::combine_futures(std::move(futures));
+  }
+
+  template <typename Parameters, typename F>
+  constexpr std::size_t get_chunk_size(Parameters &&params, F &&f,
+                                       std::size_t cores,
+                                       std::size_t count) const {
+    return std::size_t(-1);
+  }
+
+private:
+  void check_instances() const {
+    if (instances_.empty()) {
+      throw std::runtime_error(
+          "partitioning_executor: at least one instance is required");
+    }
+  }
+
+  std::vector<execution_space> instances_;
+  future_strategy strategy_ = future_strategy::unspecified;
+};
+
+template <typename Executor>
+struct is_partitioning_executor
+    : std::is_base_of<
+          partitioning_executor<typename Executor::execution_space>,
+          Executor> {};
+
+template <typename ExecutionSpace>
+struct is_kokkos_executor<partitioning_executor<ExecutionSpace>>
+    : std::true_type {};
+
+namespace detail {
+template <typename Executor>
+struct partitioned_launch<
+    Executor,
+    typename std::enable_if<is_partitioning_executor<Executor>::value>::type> {
+  template <typename I, typename Launch>
+  static auto call(Executor const &exec, char const *, I first, I last,
+                   Launch &&launch) {
+    using execution_space = typename Executor::execution_space;
+    using future_type =
+        decltype(launch(execution_space(exec.instances().front()), first,
+                        last));
+
+    auto const n = static_cast<std::size_t>(last - first);
+    std::size_t const blocks = effective_num_chunks(n, exec.size());
+    std::vector<future_type> futures;
+    futures.reserve(blocks);
+    for (std::size_t b = 0; b < blocks; ++b) {
+      auto const bounds = chunk_bounds(n, blocks, b);
+      futures.push_back(launch(execution_space(exec.instances()[b]),
+                               I(first + bounds.first),
+                               I(first + bounds.second)));
+    }
+    return futures;
+  }
+};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
+
+namespace HPXKOKKOS_HPX_EXECUTOR_NS {
+template <typename ExecutionSpace>
+struct is_one_way_executor<hpx::kokkos::partitioning_executor<ExecutionSpace>>
+    : std::true_type {};
+
+template <typename ExecutionSpace>
+struct is_two_way_executor<hpx::kokkos::partitioning_executor<ExecutionSpace>>
+    : std::true_type {};
+} // namespace HPXKOKKOS_HPX_EXECUTOR_NS
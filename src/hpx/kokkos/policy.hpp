@@ -16,8 +16,14 @@
 #include <hpx/execution.hpp>
 #include <hpx/future.hpp>
 
+#include <cstddef>
+
 namespace hpx {
 namespace kokkos {
+/// The inline threshold of policies that use the global threshold (see
+/// set_inline_threshold).
+static constexpr std::size_t default_inline_threshold = std::size_t(-1);
+
 struct kokkos_task_policy;
 template <typename Executor, typename Parameters>
 struct kokkos_task_policy_shim;
@@ -75,6 +81,15 @@ struct kokkos_task_policy {
   }
   char const *label() const { return label_; }
 
+  /// Ranges with at most threshold iterations run inline on the calling
+  /// thread if the executor allows it.
+  kokkos_task_policy inline_threshold(std::size_t threshold) const {
+    auto p = *this;
+    p.inline_threshold_ = threshold;
+    return p;
+  }
+  std::size_t inline_threshold() const { return inline_threshold_; }
+
   executor_type executor() const { return executor_type{}; }
 
   executor_parameters_type &parameters() { return params_; }
@@ -85,6 +100,7 @@ struct kokkos_task_policy {
 private:
   executor_parameters_type params_{};
   char const *label_ = "unnamed kernel";
+  std::size_t inline_threshold_ = default_inline_threshold;
 };
 
 template <typename Executor, typename Parameters>
@@ -135,6 +151,12 @@ struct kokkos_task_policy_shim : kokkos_task_policy {
   }
   char const *label() const { return label_; }
 
+  kokkos_task_policy_shim &inline_threshold(std::size_t threshold) {
+    inline_threshold_ = threshold;
+    return *this;
+  }
+  std::size_t inline_threshold() const { return inline_threshold_; }
+
   Executor &executor() { return exec_; }
 
   Executor const &executor() const { return exec_; }
@@ -159,6 +181,7 @@ private:
   Executor exec_;
   Parameters params_;
   char const *label_ = "unnamed kernel";
+  std::size_t inline_threshold_ = default_inline_threshold;
 };
 
 struct kokkos_policy {
@@ -211,6 +234,15 @@ struct kokkos_policy {
   }
   char const *label() const { return label_; }
 
+  /// Ranges with at most threshold iterations run inline on the calling
+  /// thread if the executor allows it.
+  kokkos_policy inline_threshold(std::size_t threshold) const {
+    auto p = *this;
+    p.inline_threshold_ = threshold;
+    return p;
+  }
+  std::size_t inline_threshold() const { return inline_threshold_; }
+
 public:
   executor_type executor() const { return executor_type{}; }
 
@@ -222,6 +254,7 @@ public:
 private:
   executor_parameters_type params_{};
   char const *label_ = "unnamed kernel";
+  std::size_t inline_threshold_ = default_inline_threshold;
 };
 
 template <typename Executor, typename Parameters>
@@ -272,6 +305,12 @@ struct kokkos_policy_shim : kokkos_policy {
   }
   char const *label() const { return label_; }
 
+  kokkos_policy_shim &inline_threshold(std::size_t threshold) {
+    inline_threshold_ = threshold;
+    return *this;
+  }
+  std::size_t inline_threshold() const { return inline_threshold_; }
+
   Executor &executor() { return exec_; }
 
   Executor const &executor() const { return exec_; }
@@ -296,6 +335,7 @@ private:
   Executor exec_{};
   Parameters params_{};
   char const *label_ = "unnamed kernel";
+  std::size_t inline_threshold_ = default_inline_threshold;
   /// \endcond
 };
 
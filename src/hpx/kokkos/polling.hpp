@@ -0,0 +1,447 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains control of polling for the completion of futures. Futures that are
+/// completed by events are either polled from the scheduler loop of an HPX
+/// thread pool, or adaptively from a polling task that only runs while futures
+/// that need polling are in flight and backs off exponentially while polling
+/// makes no progress. Polling from the scheduler loop of the default pool is
+/// enabled automatically when the runtime starts.
+
+#pragma once
+
+#include <hpx/config.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/future.hpp>
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+#include <hpx/include/performance_counters.hpp>
+#endif
+#include <hpx/include/resource_partitioner.hpp>
+#include <hpx/runtime.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+#include <hpx/thread.hpp>
+
+#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
+#include <hpx/modules/async_cuda.hpp>
+#endif
+#if defined(HPX_HAVE_SYCL)
+#include <hpx/modules/async_sycl.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+/// \brief Tunable parameters of adaptive polling.
+struct polling_parameters {
+  /// The first sleep after polling made no progress. Polling yields instead of
+  /// sleeping on the first poll without progress.
+  std::chrono::nanoseconds min_backoff{std::chrono::microseconds(1)};
+  /// The longest sleep between polls without progress.
+  std::chrono::nanoseconds max_backoff{std::chrono::milliseconds(1)};
+  /// The factor by which the sleep grows after every poll without progress.
+  double backoff_factor = 2.0;
+};
+
+/// \brief Counters of adaptive polling since startup.
+struct polling_statistics {
+  /// Number of times the backends were polled.
+  std::uint64_t polls = 0;
+  /// Number of polls that completed no future.
+  std::uint64_t idle_polls = 0;
+  /// Number of times the polling task slept between polls.
+  std::uint64_t sleeps = 0;
+  /// Number of futures completed while tracked by adaptive polling.
+  std::uint64_t completions = 0;
+  /// Number of instances fenced by the polling task.
+  std::uint64_t fences = 0;
+  /// Number of times the polling task was started.
+  std::uint64_t starts = 0;
+  /// Number of futures currently tracked by adaptive polling.
+  std::int64_t in_flight = 0;
+  /// Whether the polling task is currently running.
+  bool active = false;
+};
+
+namespace detail {
+inline hpx::threads::thread_pool_base &
+get_polling_pool(std::string const &pool) {
+  return pool.empty() ? hpx::resource::get_thread_pool(0)
+                      : hpx::resource::get_thread_pool(pool);
+}
+
+/// Reference counts polling from the scheduler loop of each thread pool, so
+/// that nested and overlapping enables of the same pool do not disable polling
+/// early.
+class scheduler_polling {
+public:
+  static scheduler_polling &get() {
+    static scheduler_polling p;
+    return p;
+  }
+
+  void enable(std::string const &pool) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    if (counts[pool]++ == 0) {
+      auto &p = get_polling_pool(pool);
+#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
+      hpx::cuda::experimental::detail::register_polling(p);
+#endif
+#if defined(HPX_HAVE_SYCL)
+      hpx::sycl::experimental::detail::register_polling(p);
+#endif
+      (void)p;
+    }
+  }
+
+  void disable(std::string const &pool) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto it = counts.find(pool);
+    if (it == counts.end() || it->second == 0) {
+      return;
+    }
+    if (--it->second == 0) {
+      auto &p = get_polling_pool(pool);
+#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
+      hpx::cuda::experimental::detail::unregister_polling(p);
+#endif
+#if defined(HPX_HAVE_SYCL)
+      hpx::sycl::experimental::detail::unregister_polling(p);
+#endif
+      (void)p;
+    }
+  }
+
+  bool enabled(std::string const &pool) const {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    auto it = counts.find(pool);
+    return it != counts.end() && it->second > 0;
+  }
+
+private:
+  scheduler_polling() = default;
+
+  mutable hpx::spinlock mutex;
+  std::map<std::string, std::size_t> counts;
+};
+
+class poller {
+public:
+  static poller &get() {
+    static poller p;
+    return p;
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void enable(bool e) { enabled_.store(e, std::memory_order_relaxed); }
+
+  polling_parameters parameters() const {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    return params;
+  }
+
+  void set_parameters(polling_parameters const &p) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    params = p;
+  }
+
+  std::string pool() const {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    return pool_;
+  }
+
+  void set_pool(std::string const &pool) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    pool_ = pool;
+  }
+
+  polling_statistics statistics() const {
+    polling_statistics s;
+    s.polls = polls.load(std::memory_order_relaxed);
+    s.idle_polls = idle_polls.load(std::memory_order_relaxed);
+    s.sleeps = sleeps.load(std::memory_order_relaxed);
+    s.completions = completions.load(std::memory_order_relaxed);
+    s.fences = fences.load(std::memory_order_relaxed);
+    s.starts = starts.load(std::memory_order_relaxed);
+    s.in_flight = in_flight.load(std::memory_order_relaxed);
+    s.active = running.load(std::memory_order_relaxed);
+    return s;
+  }
+
+  /// Keeps the polling task running until f is ready. f must be completed by
+  /// polling a backend.
+  hpx::shared_future<void> track(hpx::shared_future<void> f) {
+    started();
+    f.then(hpx::launch::sync, [this](auto &&) { finished(); });
+    return f;
+  }
+
+  /// Returns a future that becomes ready when all work submitted to inst so
+  /// far has completed, by fencing inst from the polling task.
+  template <typename ExecutionSpace>
+  hpx::shared_future<void> fence(ExecutionSpace const &inst) {
+    auto p = std::make_shared<hpx::promise<void>>();
+    hpx::shared_future<void> f = p->get_future();
+    {
+      std::lock_guard<hpx::spinlock> l(mutex);
+      fence_jobs.push_back([inst, p] {
+        inst.fence();
+        p->set_value();
+      });
+    }
+    return track(f);
+  }
+
+private:
+  poller() = default;
+
+  void started() {
+    in_flight.fetch_add(1, std::memory_order_relaxed);
+    if (!running.load(std::memory_order_acquire) &&
+        !running.exchange(true, std::memory_order_acq_rel)) {
+      starts.fetch_add(1, std::memory_order_relaxed);
+      hpx::execution::parallel_executor exec(&get_polling_pool(pool()));
+      hpx::async(exec, [this] { run(); });
+    }
+  }
+
+  void finished() {
+    completions.fetch_add(1, std::memory_order_relaxed);
+    in_flight.fetch_sub(1, std::memory_order_release);
+  }
+
+  // Polls all backends once and runs the fences queued so far
+  void poll_once() {
+#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
+    hpx::cuda::experimental::detail::poll();
+#endif
+#if defined(HPX_HAVE_SYCL)
+    hpx::sycl::experimental::detail::poll();
+#endif
+
+    std::vector<std::function<void()>> jobs;
+    {
+      std::lock_guard<hpx::spinlock> l(mutex);
+      jobs.swap(fence_jobs);
+    }
+    for (auto &job : jobs) {
+      job();
+    }
+    fences.fetch_add(jobs.size(), std::memory_order_relaxed);
+    polls.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void run() {
+    auto const p = parameters();
+    std::chrono::nanoseconds backoff{0};
+    for (;;) {
+      auto const before = completions.load(std::memory_order_relaxed);
+      poll_once();
+      if (completions.load(std::memory_order_relaxed) != before) {
+        backoff = std::chrono::nanoseconds(0);
+        continue;
+      }
+
+      idle_polls.fetch_add(1, std::memory_order_relaxed);
+      if (in_flight.load(std::memory_order_acquire) == 0) {
+        // Stop polling, unless a future was tracked after the check and
+        // missed that the polling task was still running
+        running.store(false, std::memory_order_release);
+        if (in_flight.load(std::memory_order_acquire) == 0 ||
+            running.exchange(true, std::memory_order_acq_rel)) {
+          return;
+        }
+      }
+
+      if (backoff.count() == 0) {
+        hpx::this_thread::yield();
+        backoff = p.min_backoff;
+      } else {
+        sleeps.fetch_add(1, std::memory_order_relaxed);
+        hpx::this_thread::sleep_for(backoff);
+        backoff = std::min(
+            p.max_backoff,
+            std::chrono::nanoseconds(static_cast<std::int64_t>(
+                static_cast<double>(backoff.count()) * p.backoff_factor)));
+      }
+    }
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<bool> running{false};
+  std::atomic<std::int64_t> in_flight{0};
+  std::atomic<std::uint64_t> polls{0};
+  std::atomic<std::uint64_t> idle_polls{0};
+  std::atomic<std::uint64_t> sleeps{0};
+  std::atomic<std::uint64_t> completions{0};
+  std::atomic<std::uint64_t> fences{0};
+  std::atomic<std::uint64_t> starts{0};
+  mutable hpx::spinlock mutex;
+  polling_parameters params;
+  std::string pool_;
+  std::vector<std::function<void()>> fence_jobs;
+};
+
+/// Tracks f with adaptive polling, if enabled.
+inline hpx::shared_future<void> polled(hpx::shared_future<void> f) {
+  auto &p = poller::get();
+  return p.enabled() ? p.track(std::move(f)) : f;
+}
+} // namespace detail
+
+/// Enables polling from the scheduler loop of the given HPX thread pool, or the
+/// default pool if empty. Polling from the default pool is enabled
+/// automatically at startup, unless disabled with
+/// --hpx:ini=hpx.kokkos.polling=off or replaced by adaptive polling with
+/// --hpx:ini=hpx.kokkos.polling=adaptive. The pool can be changed with
+/// --hpx:ini=hpx.kokkos.polling_pool=<pool>. Enabling a pool more than once
+/// requires disabling it as many times.
+inline void enable_polling(std::string const &pool = "") {
+  detail::scheduler_polling::get().enable(pool);
+}
+
+inline void disable_polling(std::string const &pool = "") {
+  detail::scheduler_polling::get().disable(pool);
+}
+
+inline bool polling_enabled(std::string const &pool = "") {
+  return detail::scheduler_polling::get().enabled(pool);
+}
+
+/// \brief Enables polling from the scheduler loop of an HPX thread pool for the
+/// lifetime of the object.
+class polling_scope {
+public:
+  explicit polling_scope(std::string pool = "") : pool(std::move(pool)) {
+    enable_polling(this->pool);
+  }
+  ~polling_scope() { disable_polling(pool); }
+
+  polling_scope(polling_scope const &) = delete;
+  polling_scope &operator=(polling_scope const &) = delete;
+
+private:
+  std::string pool;
+};
+
+/// Enables or disables adaptive polling. Adaptive polling is disabled by
+/// default. While enabled, event futures and futures of the fence strategy
+/// are completed by a polling task that only runs while such futures are in
+/// flight, on the pool set with set_adaptive_polling_pool.
+inline void enable_adaptive_polling(bool enable = true) {
+  detail::poller::get().enable(enable);
+}
+
+inline bool adaptive_polling_enabled() {
+  return detail::poller::get().enabled();
+}
+
+/// Sets the HPX thread pool that the adaptive polling task runs on, or the
+/// default pool if empty. Takes effect the next time the task starts.
+inline void set_adaptive_polling_pool(std::string const &pool) {
+  detail::poller::get().set_pool(pool);
+}
+
+inline void set_polling_parameters(polling_parameters const &p) {
+  detail::poller::get().set_parameters(p);
+}
+
+inline polling_parameters get_polling_parameters() {
+  return detail::poller::get().parameters();
+}
+
+inline polling_statistics get_polling_statistics() {
+  return detail::poller::get().statistics();
+}
+
+/// Returns the number of events and fences that are waiting to be completed
+/// by polling.
+inline std::size_t get_pending_polling_events() {
+  std::size_t n = static_cast<std::size_t>(
+      std::max<std::int64_t>(get_polling_statistics().in_flight, 0));
+#if defined(HPX_HAVE_CUDA) || defined(HPX_HAVE_HIP)
+  n += hpx::cuda::experimental::detail::get_number_of_active_events();
+#endif
+#if defined(HPX_HAVE_SYCL)
+  n += hpx::sycl::experimental::detail::get_number_of_active_events();
+#endif
+  return n;
+}
+
+namespace detail {
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+// Performance counters are only available with the distributed runtime
+inline void register_polling_counters() {
+  using hpx::performance_counters::install_counter_type;
+
+  install_counter_type(
+      "/hpx-kokkos/polling/polls",
+      [](bool) {
+        return static_cast<std::int64_t>(get_polling_statistics().polls);
+      },
+      "returns the number of times backends were polled by adaptive polling");
+  install_counter_type(
+      "/hpx-kokkos/polling/idle-polls",
+      [](bool) {
+        return static_cast<std::int64_t>(get_polling_statistics().idle_polls);
+      },
+      "returns the number of polls that completed no future");
+  install_counter_type(
+      "/hpx-kokkos/polling/sleeps",
+      [](bool) {
+        return static_cast<std::int64_t>(get_polling_statistics().sleeps);
+      },
+      "returns the number of times the polling task backed off");
+  install_counter_type(
+      "/hpx-kokkos/polling/inflight",
+      [](bool) { return get_polling_statistics().in_flight; },
+      "returns the number of futures currently tracked by adaptive polling");
+  install_counter_type(
+      "/hpx-kokkos/polling/pending",
+      [](bool) {
+        return static_cast<std::int64_t>(get_pending_polling_events());
+      },
+      "returns the number of events and fences waiting to be completed by "
+      "polling");
+}
+#endif
+
+inline void start_polling() {
+  std::string const mode = hpx::get_config_entry("hpx.kokkos.polling", "");
+  std::string const pool = hpx::get_config_entry("hpx.kokkos.polling_pool", "");
+  set_adaptive_polling_pool(pool);
+  if (mode == "adaptive") {
+    enable_adaptive_polling();
+  } else if (mode != "off") {
+    enable_polling(pool);
+    hpx::register_shutdown_function([pool] { disable_polling(pool); });
+  }
+}
+
+struct polling_registration {
+  polling_registration() {
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+    hpx::register_pre_startup_function(&register_polling_counters);
+#endif
+    hpx::register_startup_function(&start_polling);
+  }
+};
+
+inline polling_registration const polling_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -0,0 +1,280 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Contains tracing of asynchronous launches. Launches are reported to Kokkos
+/// Tools as regions tagged with the launching HPX thread, and are recorded
+/// together with the time their futures become ready for output in the Chrome
+/// trace event format.
+
+#pragma once
+
+#include <hpx/chrono.hpp>
+#include <hpx/runtime.hpp>
+#include <hpx/synchronization/spinlock.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hpx {
+namespace kokkos {
+namespace detail {
+inline std::uintptr_t current_hpx_thread() {
+  return reinterpret_cast<std::uintptr_t>(hpx::threads::get_self_id().get());
+}
+
+/// Pushes a Kokkos Tools region for a launch, if a tool is loaded, for the
+/// lifetime of the object. Kernels launched within the region can be
+/// correlated with the HPX thread that launched them.
+class tools_launch_region {
+public:
+  tools_launch_region(bool enabled, char const *label)
+      : pushed(enabled && Kokkos::Profiling::profileLibraryLoaded()) {
+    if (pushed) {
+      char thread[32];
+      std::snprintf(thread, sizeof(thread), "%#zx",
+                    static_cast<std::size_t>(current_hpx_thread()));
+      Kokkos::Profiling::pushRegion(std::string("hpx-kokkos: ") + label +
+                                    " [hpx thread " + thread + "]");
+    }
+  }
+
+  ~tools_launch_region() {
+    if (pushed) {
+      Kokkos::Profiling::popRegion();
+    }
+  }
+
+  tools_launch_region(tools_launch_region const &) = delete;
+  tools_launch_region &operator=(tools_launch_region const &) = delete;
+
+private:
+  bool pushed;
+};
+
+/// Records launch and future-ready events. Each launch gets an id that
+/// connects it to its ready event with a flow event in the written trace.
+/// Events are kept in a ring of a bounded number of events. Once it is full
+/// the oldest events are overwritten, and the number of dropped events is
+/// written with the trace.
+class tracer {
+public:
+  static tracer &get() {
+    static tracer t;
+    return t;
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void enable(bool e) { enabled_.store(e, std::memory_order_relaxed); }
+
+  std::uint64_t launched(char const *label, std::size_t instance,
+                         std::uint64_t start, std::uint64_t end) {
+    auto const id = next_id.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<hpx::spinlock> l(mutex);
+    push(event{label, 'X', start, end - start, id,
+               hpx::get_worker_thread_num(), current_hpx_thread(), instance});
+    return id;
+  }
+
+  void ready(std::uint64_t id, char const *label, std::size_t instance,
+             std::uint64_t time) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    push(event{label, 'i', time, 0, id, hpx::get_worker_thread_num(),
+               current_hpx_thread(), instance});
+  }
+
+  void clear() {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    events.clear();
+    oldest = 0;
+    dropped_ = 0;
+  }
+
+  /// Sets the maximum number of events kept, keeping the most recent ones.
+  void set_capacity(std::size_t c) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    std::vector<event> kept;
+    std::size_t const n = (std::min)(events.size(), c);
+    kept.reserve(n);
+    for (std::size_t i = events.size() - n; i < events.size(); ++i) {
+      kept.push_back(std::move(events[(oldest + i) % events.size()]));
+    }
+    dropped_ += events.size() - n;
+    events = std::move(kept);
+    oldest = 0;
+    capacity_ = c;
+  }
+
+  std::size_t capacity() {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    return capacity_;
+  }
+
+  /// Returns the number of events that have been overwritten or not recorded
+  /// because the ring was full.
+  std::size_t dropped() {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    return dropped_;
+  }
+
+  /// The default maximum number of events kept.
+  static constexpr std::size_t default_capacity = std::size_t(1) << 16;
+
+  void write(std::ostream &os) {
+    std::lock_guard<hpx::spinlock> l(mutex);
+    os << "{\"traceEvents\":[";
+    char const *separator = "";
+    for (std::size_t i = 0; i < events.size(); ++i) {
+      auto const &e = events[(oldest + i) % events.size()];
+      bool const launch = e.phase == 'X';
+      os << separator;
+      write_event(os, e, launch ? e.name : e.name + " ready", e.phase);
+      // Flow events draw an arrow from the launch to the ready event
+      os << ',';
+      write_event(os, e, "launch", launch ? 's' : 'f');
+      separator = ",";
+    }
+    os << "],\"otherData\":{\"dropped_events\":" << dropped_ << "}}\n";
+  }
+
+private:
+  struct event {
+    std::string name;
+    char phase;
+    std::uint64_t time;
+    std::uint64_t duration;
+    std::uint64_t id;
+    std::size_t worker_thread;
+    std::uintptr_t hpx_thread;
+    std::size_t instance;
+  };
+
+  tracer() = default;
+
+  // Must be called with the mutex held
+  void push(event &&e) {
+    if (events.size() < capacity_) {
+      events.push_back(std::move(e));
+      return;
+    }
+    ++dropped_;
+    if (capacity_ > 0) {
+      events[oldest] = std::move(e);
+      oldest = (oldest + 1) % capacity_;
+    }
+  }
+
+  static void write_string(std::ostream &os, std::string const &s) {
+    os << '"';
+    for (char c : s) {
+      if (c == '"' || c == '\\') {
+        os << '\\' << c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        os << ' ';
+      } else {
+        os << c;
+      }
+    }
+    os << '"';
+  }
+
+  static void write_event(std::ostream &os, event const &e,
+                          std::string const &name, char phase) {
+    os << "{\"name\":";
+    write_string(os, name);
+    os << ",\"cat\":\"hpx-kokkos\",\"ph\":\"" << phase << "\",\"ts\":"
+       << e.time / 1000.0 << ",\"pid\":" << hpx::get_locality_id()
+       << ",\"tid\":" << e.worker_thread;
+    if (phase == 'X') {
+      os << ",\"dur\":" << e.duration / 1000.0;
+    } else if (phase == 'i') {
+      os << ",\"s\":\"t\"";
+    } else {
+      os << ",\"id\":" << e.id;
+      if (phase == 'f') {
+        os << ",\"bp\":\"e\"";
+      }
+    }
+    os << ",\"args\":{\"id\":" << e.id << ",\"hpx_thread\":" << e.hpx_thread
+       << ",\"instance\":" << e.instance << "}}";
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<std::uint64_t> next_id{1};
+  hpx::spinlock mutex;
+  std::vector<event> events;
+  std::size_t oldest = 0;
+  std::size_t capacity_ = default_capacity;
+  std::size_t dropped_ = 0;
+};
+} // namespace detail
+
+/// Enables or disables tracing of launches. Tracing is disabled by default,
+/// and can also be enabled at startup with --hpx:ini=hpx.kokkos.trace=<file>,
+/// in which case the trace is written to file at shutdown.
+inline void enable_tracing(bool enable = true) {
+  detail::tracer::get().enable(enable);
+}
+
+/// Writes the events traced so far in the Chrome trace event format.
+inline void write_trace(std::ostream &os) { detail::tracer::get().write(os); }
+
+inline void write_trace(std::string const &filename) {
+  std::ofstream os(filename);
+  write_trace(os);
+}
+
+/// Discards the events traced so far.
+inline void clear_trace() { detail::tracer::get().clear(); }
+
+/// Sets the maximum number of events kept while tracing. Once it is reached
+/// the oldest events are overwritten. The capacity can also be set at startup
+/// with --hpx:ini=hpx.kokkos.trace_capacity=<events>.
+inline void set_trace_capacity(std::size_t capacity) {
+  detail::tracer::get().set_capacity(capacity);
+}
+
+/// Returns the number of traced events that have been dropped since the trace
+/// was last cleared.
+inline std::size_t get_trace_dropped_events() {
+  return detail::tracer::get().dropped();
+}
+
+namespace detail {
+inline void register_trace_output() {
+  std::string const capacity =
+      hpx::get_config_entry("hpx.kokkos.trace_capacity", "");
+  if (!capacity.empty()) {
+    set_trace_capacity(std::stoul(capacity));
+  }
+
+  std::string const filename = hpx::get_config_entry("hpx.kokkos.trace", "");
+  if (!filename.empty()) {
+    enable_tracing();
+    hpx::register_shutdown_function([filename] { write_trace(filename); });
+  }
+}
+
+struct trace_registration {
+  trace_registration() {
+    hpx::register_pre_startup_function(&register_trace_output);
+  }
+};
+
+inline trace_registration const trace_registration_instance{};
+} // namespace detail
+} // namespace kokkos
+} // namespace hpx
@@ -16,7 +16,6 @@
 #include <hpx/chrono.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
 
 template <typename ExecutionSpace>
 void test_kokkos_plain(ExecutionSpace &&inst, int const n,
@@ -213,9 +212,6 @@ int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
   {
-    hpx::kokkos::detail::polling_helper p;
-    (void)p;
-
     test(Kokkos::DefaultExecutionSpace(), n, repetitions);
     if (!std::is_same<Kokkos::DefaultExecutionSpace,
                       Kokkos::DefaultHostExecutionSpace>::value) {
@@ -0,0 +1,110 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests autotuning of the launch parameters of HPX algorithms and reading and
+/// writing of the autotuning cache.
+
+#include "test.hpp"
+
+#include <hpx/algorithm.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <sstream>
+#include <string>
+
+template <typename ExecutionSpace> void test() {
+  hpx::kokkos::clear_autotuning();
+
+  // Results are correct while candidates are explored and after the fastest
+  // has been chosen
+  int const n = 1000;
+  int const iterations = 20;
+  Kokkos::View<int *, ExecutionSpace> data("data", n);
+  for (int it = 0; it < iterations; ++it) {
+    hpx::experimental::for_loop(
+        hpx::kokkos::kok(hpx::execution::task)
+            .on(hpx::kokkos::executor<ExecutionSpace>{})
+            .label("autotune for_loop"),
+        0, n, KOKKOS_LAMBDA(int i) { data(i) += i; })
+        .get();
+  }
+
+  auto data_host = Kokkos::create_mirror_view(data);
+  Kokkos::deep_copy(data_host, data);
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == iterations * i);
+  }
+
+  using limit_type = Kokkos::Array<long, 2>;
+  Kokkos::View<int **, ExecutionSpace> data_2d("data_2d", 10, n);
+  for (int it = 0; it < iterations; ++it) {
+    hpx::experimental::for_loop(
+        hpx::kokkos::kok(hpx::execution::task)
+            .on(hpx::kokkos::executor<ExecutionSpace>{})
+            .label("autotune for_loop 2d"),
+        limit_type({0, 0}), limit_type({10, n}),
+        KOKKOS_LAMBDA(long i, long j) { data_2d(i, j) += i + j; })
+        .get();
+  }
+
+  auto data_2d_host = Kokkos::create_mirror_view(data_2d);
+  Kokkos::deep_copy(data_2d_host, data_2d);
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < n; ++j) {
+      HPX_KOKKOS_DETAIL_TEST(data_2d_host(i, j) == iterations * (i + j));
+    }
+  }
+
+  // With one sample per candidate all candidates have been tried, so both
+  // labels are tuned and written to the cache
+  std::ostringstream cache;
+  hpx::kokkos::write_autotuning_cache(cache);
+  HPX_KOKKOS_DETAIL_TEST(cache.str().find(" autotune for_loop\n") !=
+                         std::string::npos);
+  HPX_KOKKOS_DETAIL_TEST(cache.str().find(" autotune for_loop 2d\n") !=
+                         std::string::npos);
+
+  // Reading the cache restores the same tuned parameters
+  hpx::kokkos::clear_autotuning();
+  std::ostringstream empty;
+  hpx::kokkos::write_autotuning_cache(empty);
+  HPX_KOKKOS_DETAIL_TEST(empty.str().empty());
+
+  std::istringstream is(cache.str() + "malformed line\n");
+  hpx::kokkos::read_autotuning_cache(is);
+  std::ostringstream restored;
+  hpx::kokkos::write_autotuning_cache(restored);
+  HPX_KOKKOS_DETAIL_TEST(restored.str() == cache.str());
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    hpx::kokkos::enable_autotuning();
+    hpx::kokkos::set_autotuning_samples(1);
+
+    test<Kokkos::DefaultExecutionSpace>();
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test<Kokkos::DefaultHostExecutionSpace>();
+    }
+
+    hpx::kokkos::enable_autotuning(false);
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
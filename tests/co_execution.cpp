@@ -0,0 +1,107 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests splitting algorithms between a host and a device executor with
+/// co_executor. Both sides use host execution spaces so that the test does not
+/// need memory accessible from host and device.
+
+#include "test.hpp"
+
+#include <hpx/algorithm.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+
+template <typename HostExecutionSpace, typename DeviceExecutionSpace>
+void test() {
+  using executor_type =
+      hpx::kokkos::co_executor<HostExecutionSpace, DeviceExecutionSpace>;
+  executor_type exec(
+      hpx::kokkos::executor<HostExecutionSpace>(
+          hpx::kokkos::execution_space_mode::independent),
+      hpx::kokkos::executor<DeviceExecutionSpace>(
+          hpx::kokkos::execution_space_mode::independent),
+      0.25);
+
+  HPX_KOKKOS_DETAIL_TEST(exec.host_fraction("co_execution unused") == 0.25);
+  exec.set_host_fraction("co_execution unused", 2.0);
+  HPX_KOKKOS_DETAIL_TEST(exec.host_fraction("co_execution unused") < 1.0);
+
+  int const n = 1000;
+  Kokkos::View<int *, Kokkos::HostSpace> data("data", n);
+  Kokkos::View<int *, Kokkos::HostSpace> result("result", n);
+
+  // The split changes between iterations, but every element must be visited
+  // exactly once by each call
+  int const iterations = 10;
+  for (int it = 0; it < iterations; ++it) {
+    hpx::experimental::for_loop(
+        hpx::kokkos::kok(hpx::execution::task)
+            .on(exec)
+            .label("co_execution for_loop"),
+        0, n, KOKKOS_LAMBDA(int i) { data(i) += i; })
+        .get();
+  }
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data(i) == iterations * i);
+  }
+
+  for (int it = 0; it < iterations; ++it) {
+    int const sum =
+        hpx::reduce(hpx::kokkos::kok.on(exec).label("co_execution reduce"),
+                    data.data(), data.data() + n, 1,
+                    KOKKOS_LAMBDA(int x, int y) { return x + y; });
+    HPX_KOKKOS_DETAIL_TEST(sum == 1 + iterations * (n * (n - 1)) / 2);
+  }
+
+  for (int it = 0; it < iterations; ++it) {
+    auto const last =
+        hpx::transform(hpx::kokkos::kok(hpx::execution::task)
+                           .on(exec)
+                           .label("co_execution transform"),
+                       data.data(), data.data() + n, result.data(),
+                       KOKKOS_LAMBDA(int x) { return x + 1; })
+            .get();
+    HPX_KOKKOS_DETAIL_TEST(last == result.data() + n);
+  }
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(result(i) == iterations * i + 1);
+  }
+
+  exec.get_future().get();
+
+  for (auto label : {"co_execution for_loop", "co_execution reduce",
+                     "co_execution transform"}) {
+    double const fraction = exec.host_fraction(label);
+    HPX_KOKKOS_DETAIL_TEST(fraction > 0.0);
+    HPX_KOKKOS_DETAIL_TEST(fraction < 1.0);
+  }
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test<Kokkos::DefaultHostExecutionSpace,
+         Kokkos::DefaultHostExecutionSpace>();
+#if defined(KOKKOS_ENABLE_SERIAL)
+    if (!std::is_same<Kokkos::DefaultHostExecutionSpace,
+                      Kokkos::Serial>::value) {
+      test<Kokkos::Serial, Kokkos::DefaultHostExecutionSpace>();
+    }
+#endif
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,137 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests awaiting futures, execution space instances, and executors in
+/// coroutines. The coroutines return HPX futures, so this is only tested when
+/// both the compiler and HPX support coroutines, and is reported as skipped
+/// otherwise.
+
+#include "test.hpp"
+
+#include <hpx/config.hpp>
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+#if defined(HPX_KOKKOS_HAVE_COROUTINES) && defined(HPX_HAVE_CXX20_COROUTINES)
+template <typename ExecutionSpace, typename Kernel>
+hpx::future<void> pipeline(ExecutionSpace inst, Kernel kernel, int n,
+                           int steps) {
+  for (int s = 0; s < steps; ++s) {
+    co_await hpx::kokkos::awaitable(hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<ExecutionSpace>(inst, 0, n), kernel));
+  }
+}
+
+template <typename ExecutionSpace, typename Kernel>
+hpx::future<void> executor_pipeline(hpx::kokkos::executor<ExecutionSpace> exec,
+                                    Kernel kernel, int n) {
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(exec.instance(), 0, n), kernel);
+  co_await exec;
+  co_await hpx::kokkos::awaitable(exec.instance());
+}
+
+hpx::future<bool> await_exception() {
+  try {
+    co_await hpx::kokkos::awaitable(
+        hpx::make_exceptional_future<void>(std::runtime_error("awaited")));
+  } catch (std::runtime_error const &) {
+    co_return true;
+  }
+  co_return false;
+}
+
+hpx::future<bool> await_promise(hpx::shared_future<void> f) {
+  co_await hpx::kokkos::awaitable(f);
+  // Resumed on an HPX worker even though f was made ready outside of HPX
+  co_return hpx::threads::get_self_ptr() != nullptr;
+}
+
+// Futures that become ready while the coroutine suspends either continue it
+// inline or resume it once, but never resume it from within await_suspend
+hpx::future<int> await_racing(int repetitions) {
+  int completed = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    hpx::promise<void> p;
+    auto f = p.get_future().share();
+    std::thread t([&p] { p.set_value(); });
+    co_await hpx::kokkos::awaitable(f);
+    t.join();
+    ++completed;
+  }
+  co_return completed;
+}
+
+template <typename ExecutionSpace> void test() {
+  ExecutionSpace inst;
+  int const n = 43;
+  int const steps = 10;
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  Kokkos::View<int *, ExecutionSpace> data("data", n);
+  auto const increment = KOKKOS_LAMBDA(int i) { data(i) += 1; };
+
+  pipeline(inst, increment, n, steps).get();
+  executor_pipeline(hpx::kokkos::executor<ExecutionSpace>(inst), increment, n)
+      .get();
+
+  Kokkos::deep_copy(data_host, data);
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == steps + 1);
+  }
+}
+#endif
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+#if defined(HPX_KOKKOS_HAVE_COROUTINES)
+  {
+    // Ready futures resume inline
+    HPX_KOKKOS_DETAIL_TEST(
+        hpx::kokkos::awaitable(hpx::make_ready_future()).await_ready());
+
+#if defined(HPX_HAVE_CXX20_COROUTINES)
+    test<Kokkos::DefaultExecutionSpace>();
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test<Kokkos::DefaultHostExecutionSpace>();
+    }
+
+    HPX_KOKKOS_DETAIL_TEST(await_exception().get());
+
+    hpx::promise<void> p;
+    auto f = await_promise(p.get_future().share());
+    std::thread t([&p] { p.set_value(); });
+    HPX_KOKKOS_DETAIL_TEST(f.get());
+    t.join();
+
+    HPX_KOKKOS_DETAIL_TEST(await_racing(100).get() == 100);
+#endif
+  }
+#endif
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+#if defined(HPX_KOKKOS_HAVE_COROUTINES) && defined(HPX_HAVE_CXX20_COROUTINES)
+  return hpx::kokkos::detail::report_errors();
+#else
+  // Reported as skipped by CTest
+  return 77;
+#endif
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,116 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests launching kernels from the completion of their dependencies with
+/// hpx::kokkos::dataflow.
+
+#include "test.hpp"
+
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+template <typename ExecutionSpace> void test(ExecutionSpace const &inst) {
+  int const n = 43;
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  Kokkos::View<int *, ExecutionSpace> data("data", n);
+
+  // Kernels are defined outside of the launching lambdas for nvcc
+  auto const init = KOKKOS_LAMBDA(int i) { data(i) = i; };
+  auto const increment = KOKKOS_LAMBDA(int i) { data(i) += 1; };
+  auto const twice = KOKKOS_LAMBDA(int i) { data(i) *= 2; };
+
+  // Nothing is launched before all dependencies are ready
+  hpx::promise<void> p;
+  hpx::promise<int> q;
+  bool launched = false;
+  auto f = hpx::kokkos::dataflow(
+      inst,
+      [&](ExecutionSpace const &space) {
+        launched = true;
+        return hpx::kokkos::parallel_for_async(
+            Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), init);
+      },
+      p.get_future(), q.get_future());
+
+  HPX_KOKKOS_DETAIL_TEST(!launched);
+  p.set_value();
+  HPX_KOKKOS_DETAIL_TEST(!launched);
+  q.set_value(42);
+  f.get();
+  HPX_KOKKOS_DETAIL_TEST(launched);
+
+  // Ready dependencies and dependencies from the same instance, also in
+  // ranges, are satisfied
+  std::vector<hpx::shared_future<void>> deps{f, hpx::make_ready_future()};
+  auto g = hpx::kokkos::dataflow(
+      inst,
+      [=](ExecutionSpace const &space) {
+        return hpx::kokkos::parallel_for_async(
+            Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), increment);
+      },
+      deps, hpx::make_ready_future(3));
+  auto h = hpx::kokkos::dataflow(
+      inst,
+      [=](ExecutionSpace const &space) {
+        return hpx::kokkos::parallel_for_async(
+            Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), twice);
+      },
+      g);
+  hpx::kokkos::deep_copy_async(h, inst, data_host, data).get();
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 2 * (i + 1));
+  }
+
+  // Exceptions of dependencies are propagated without calling the kernel
+  hpx::promise<void> r;
+  launched = false;
+  auto e = hpx::kokkos::dataflow(
+      inst,
+      [&](ExecutionSpace const &space) {
+        launched = true;
+        return hpx::kokkos::parallel_for_async(
+            Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), init);
+      },
+      r.get_future(),
+      hpx::make_exceptional_future<void>(std::runtime_error("dependency")));
+  r.set_value();
+
+  bool caught = false;
+  try {
+    e.get();
+  } catch (std::runtime_error const &) {
+    caught = true;
+  }
+  HPX_KOKKOS_DETAIL_TEST(caught);
+  HPX_KOKKOS_DETAIL_TEST(!launched);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
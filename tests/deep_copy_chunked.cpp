@@ -0,0 +1,118 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests chunked asynchronous deep copies.
+
+#include "test.hpp"
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <vector>
+
+template <typename ExecutionSpace>
+void test_deep_copy_chunked(ExecutionSpace &&inst,
+                            std::size_t const num_chunks) {
+  int const n = 43;
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> src_host("src_host",
+                                                                  n);
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> dst_host("dst_host",
+                                                                  n);
+  Kokkos::View<int *, typename std::decay<ExecutionSpace>::type> data("data",
+                                                                      n);
+  for (std::size_t i = 0; i < n; ++i) {
+    src_host(i) = i;
+    dst_host(i) = 0;
+  }
+
+  auto to_device =
+      hpx::kokkos::deep_copy_async_chunked(inst, data, src_host, num_chunks);
+  HPX_KOKKOS_DETAIL_TEST(to_device.size() ==
+                         (std::min)(num_chunks, std::size_t(n)));
+
+  // Chunks can be consumed as soon as they are ready
+  std::vector<hpx::shared_future<void>> consumed;
+  for (std::size_t c = 0; c < to_device.size(); ++c) {
+    auto chunk = hpx::kokkos::view_chunk(data, to_device.size(), c);
+    to_device[c].get();
+    consumed.push_back(hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<typename std::decay<ExecutionSpace>::type>(
+            inst, 0, chunk.extent(0)),
+        KOKKOS_LAMBDA(int i) { chunk(i) *= 2; }));
+  }
+  hpx::wait_all(consumed);
+
+  hpx::wait_all(
+      hpx::kokkos::deep_copy_async_chunked(inst, dst_host, data, num_chunks));
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(dst_host(i) == 2 * i);
+  }
+}
+
+template <typename ExecutionSpace>
+void test_deep_copy_chunked_2d(ExecutionSpace &&inst) {
+  int const n = 13;
+  int const m = 7;
+  std::size_t const num_chunks = 4;
+
+  Kokkos::View<int **, Kokkos::LayoutLeft, Kokkos::DefaultHostExecutionSpace>
+      src_host("src_host", n, m);
+  Kokkos::View<int **, Kokkos::LayoutLeft, Kokkos::DefaultHostExecutionSpace>
+      dst_host("dst_host", n, m);
+  Kokkos::View<int **, Kokkos::LayoutLeft,
+               typename std::decay<ExecutionSpace>::type>
+      data("data", n, m);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < m; ++j) {
+      src_host(i, j) = i * m + j;
+      dst_host(i, j) = 0;
+    }
+  }
+
+  // Chunks of LayoutLeft views are taken along the last dimension
+  HPX_KOKKOS_DETAIL_TEST(
+      hpx::kokkos::view_chunk(src_host, num_chunks, 0).extent(0) == n);
+
+  std::vector<typename std::decay<ExecutionSpace>::type> instances{inst, inst};
+  hpx::wait_all(hpx::kokkos::deep_copy_async_chunked(instances, data, src_host,
+                                                     num_chunks));
+  hpx::wait_all(hpx::kokkos::deep_copy_async_chunked(instances, dst_host, data,
+                                                     num_chunks));
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < m; ++j) {
+      HPX_KOKKOS_DETAIL_TEST(dst_host(i, j) == int(i * m + j));
+    }
+  }
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  test_deep_copy_chunked(inst, 1);
+  test_deep_copy_chunked(inst, 4);
+  test_deep_copy_chunked(inst, 100);
+  test_deep_copy_chunked_2d(inst);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,205 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests asynchronous functions that are launched after dependencies are
+/// ready.
+
+#include "test.hpp"
+
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+template <typename ExecutionSpace>
+void test_parallel_for_after_promise(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  Kokkos::View<int *, execution_space> data("data", n);
+  for (std::size_t i = 0; i < n; ++i) {
+    data_host(i) = 0;
+  }
+  Kokkos::deep_copy(data, data_host);
+
+  hpx::promise<void> p;
+  hpx::shared_future<void> dep = p.get_future().share();
+
+  auto f = hpx::kokkos::parallel_for_async(
+      dep, Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; });
+  auto g = hpx::kokkos::deep_copy_async(f, inst, data_host, data);
+
+  // Nothing can have been launched before the dependency is ready
+  HPX_KOKKOS_DETAIL_TEST(!f.is_ready());
+  HPX_KOKKOS_DETAIL_TEST(!g.is_ready());
+
+  p.set_value();
+  g.get();
+
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == i);
+  }
+}
+
+template <typename ExecutionSpace>
+void test_parallel_reduce_after_futures(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+  std::vector<hpx::shared_future<void>> deps;
+  deps.push_back(hpx::kokkos::parallel_for_async(
+      "init", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; }));
+  deps.push_back(hpx::make_ready_future());
+
+  int sum = 0;
+  hpx::kokkos::parallel_reduce_async(
+      deps, "sum", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int const i, int &acc) { acc += data(i); },
+      Kokkos::Sum<int>(sum))
+      .get();
+  inst.fence();
+  HPX_KOKKOS_DETAIL_TEST(sum == n * (n - 1) / 2);
+
+  int scan_sum = 0;
+  hpx::kokkos::parallel_scan_async(
+      hpx::make_ready_future(),
+      Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int const i, int &update, bool const) { update += i; },
+      scan_sum)
+      .get();
+  inst.fence();
+  HPX_KOKKOS_DETAIL_TEST(scan_sum == n * (n - 1) / 2);
+}
+
+template <typename ExecutionSpace>
+void test_same_instance(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  auto other = hpx::kokkos::detail::make_independent_execution_space_instance<
+      execution_space>();
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  Kokkos::View<int *, execution_space> data("data", n);
+
+  // Origins are only recorded once they have been asked for, which the first
+  // launch with a dependency would otherwise do
+  hpx::kokkos::detail::future_origins<execution_space>::get().track();
+
+  auto f = hpx::kokkos::parallel_for_async(
+      Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; });
+
+  // Futures from in-order instances remember where they came from
+  HPX_KOKKOS_DETAIL_TEST(
+      hpx::kokkos::detail::produced_on(inst, f) ==
+      hpx::kokkos::is_execution_space_in_order<execution_space>::value);
+  if (hpx::kokkos::is_execution_space_independent<execution_space>::value) {
+    HPX_KOKKOS_DETAIL_TEST(!hpx::kokkos::detail::produced_on(other, f));
+  }
+
+  // Dependencies from the same instance do not delay the launch
+  auto g = hpx::kokkos::parallel_for_async(
+      f, Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) += 1; });
+  if (hpx::kokkos::is_execution_space_in_order<execution_space>::value) {
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::detail::produced_on(inst, g));
+  }
+
+  hpx::kokkos::deep_copy_async(g, inst, data_host, data).get();
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == i + 1);
+  }
+}
+
+template <typename ExecutionSpace>
+void test_instance_dependency(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 10000;
+
+  auto producer =
+      hpx::kokkos::detail::make_independent_execution_space_instance<
+          execution_space>();
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  Kokkos::View<int *, execution_space> a("a", n);
+  Kokkos::View<int *, execution_space> b("b", n);
+
+  hpx::kokkos::parallel_for_async(
+      Kokkos::RangePolicy<execution_space>(producer, 0, n),
+      KOKKOS_LAMBDA(int i) { a(i) = i; });
+
+  // The consumer waits for the producer instance without a host future
+  auto f = hpx::kokkos::parallel_for_async(
+      hpx::kokkos::after(producer),
+      Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { b(i) = a(i) + 1; });
+
+  // Instance and future dependencies can be combined
+  hpx::kokkos::deep_copy_async(
+      std::make_tuple(hpx::kokkos::after(inst), f), producer, data_host, b)
+      .get();
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == i + 1);
+  }
+}
+
+void test_exception_propagation() {
+  hpx::shared_future<void> dep =
+      hpx::make_exceptional_future<void>(std::runtime_error("dependency"));
+
+  bool launched = false;
+  auto f = hpx::kokkos::parallel_for_async(
+      dep, Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, 1),
+      [&](int) { launched = true; });
+
+  bool caught = false;
+  try {
+    f.get();
+  } catch (std::runtime_error const &) {
+    caught = true;
+  }
+  HPX_KOKKOS_DETAIL_TEST(caught);
+  HPX_KOKKOS_DETAIL_TEST(!launched);
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  test_parallel_for_after_promise(inst);
+  test_parallel_reduce_after_futures(inst);
+  test_same_instance(inst);
+  test_instance_dependency(inst);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+    test_exception_propagation();
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
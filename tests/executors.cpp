@@ -10,11 +10,12 @@
 
 #include <hpx/execution.hpp>
 #include <hpx/hpx_init.hpp>
+#include <hpx/iterator_support/counting_shape.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
 
 #include <atomic>
 #include <cassert>
+#include <stdexcept>
 #include <vector>
 
 template <typename Executor> void test(Executor &&exec) {
@@ -80,20 +81,115 @@ template <typename Executor> void test(Executor &&exec) {
   for (std::size_t i = 0; i < n; ++i) {
     HPX_KOKKOS_DETAIL_TEST(argument_passthrough_host(i) == 42);
   }
+
+  // Check bulk execution with a single future, several arguments, and
+  // synchronous bulk execution
+  exec.bulk_async_execute_single(
+          KOKKOS_LAMBDA(std::size_t i, int a, int b) {
+            argument_passthrough(i) = a + b;
+          },
+          hpx::util::counting_shape(n), 1, 2)
+      .get();
+  Kokkos::deep_copy(argument_passthrough_host, argument_passthrough);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(argument_passthrough_host(i) == 3);
+  }
+
+  hpx::parallel::execution::bulk_sync_execute(
+      exec,
+      KOKKOS_LAMBDA(std::size_t i) { argument_passthrough(i) = int(i); }, n);
+  Kokkos::deep_copy(argument_passthrough_host, argument_passthrough);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(argument_passthrough_host(i) == int(i));
+  }
+
+  // Check continuations not taking the predecessor; a predecessor from the
+  // same executor is a dependency of the continuation, and so is a ready future
+  auto predecessor = hpx::parallel::execution::async_execute(exec, f_single);
+  auto continuation = exec.then_execute_after(f_single, predecessor);
+  exec.bulk_then_execute_after(
+          KOKKOS_LAMBDA(std::size_t i, int offset) {
+            argument_passthrough(i) = int(i) + offset;
+          },
+          hpx::util::counting_shape(n), continuation, 1)
+      .get();
+  HPX_KOKKOS_DETAIL_TEST(continuation.is_ready());
+
+  Kokkos::deep_copy(executed_count_host, executed_count);
+  HPX_KOKKOS_DETAIL_TEST(executed_count_host() == 5);
+  Kokkos::deep_copy(argument_passthrough_host, argument_passthrough);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(argument_passthrough_host(i) == int(i) + 1);
+  }
+
+  // Continuations taking the predecessor can only run on the host
+  using execution_space = typename std::decay<Executor>::type::execution_space;
+  if constexpr (Kokkos::SpaceAccessibility<execution_space,
+                                           Kokkos::HostSpace>::accessible) {
+    hpx::promise<void> p;
+    auto g = hpx::parallel::execution::then_execute(
+        exec,
+        [executed_count](hpx::shared_future<void> f, std::size_t increment) {
+          HPX_KOKKOS_DETAIL_TEST(f.is_ready());
+          executed_count() += increment;
+        },
+        p.get_future(), std::size_t(2));
+    HPX_KOKKOS_DETAIL_TEST(!g.is_ready());
+    p.set_value();
+    g.get();
+
+    Kokkos::deep_copy(executed_count_host, executed_count);
+    HPX_KOKKOS_DETAIL_TEST(executed_count_host() == 7);
+
+    hpx::parallel::execution::bulk_then_execute(
+        exec,
+        [argument_passthrough](std::size_t i, hpx::shared_future<void> f,
+                               int offset) {
+          HPX_KOKKOS_DETAIL_TEST(f.is_ready());
+          argument_passthrough(i) = int(i) + offset;
+        },
+        hpx::util::counting_shape(n), g, 2)
+        .get();
+
+    Kokkos::deep_copy(argument_passthrough_host, argument_passthrough);
+    for (std::size_t i = 0; i < n; ++i) {
+      HPX_KOKKOS_DETAIL_TEST(argument_passthrough_host(i) == int(i) + 2);
+    }
+  }
 }
 
 int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
   {
-    hpx::kokkos::detail::polling_helper p;
-    (void)p;
-
     test(hpx::kokkos::default_executor{});
     if (!std::is_same<hpx::kokkos::default_executor,
                       hpx::kokkos::default_host_executor>::value) {
       test(hpx::kokkos::default_host_executor{});
     }
+#if defined(KOKKOS_ENABLE_SERIAL)
+    // Single launches on synchronous spaces are invoked directly
+    static_assert(
+        hpx::kokkos::is_execution_space_synchronous<Kokkos::Serial>::value,
+        "Kokkos::Serial should be synchronous");
+    if (!std::is_same<Kokkos::Serial,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(hpx::kokkos::serial_executor{});
+    }
+
+    // Exceptions from functions invoked directly are returned in the future,
+    // or dropped by post, as for a kernel
+    hpx::kokkos::serial_executor exec;
+    auto throwing = [] { throw std::runtime_error("direct"); };
+    auto f = hpx::parallel::execution::async_execute(exec, throwing);
+    HPX_KOKKOS_DETAIL_TEST(f.is_ready() && f.has_exception());
+    hpx::parallel::execution::post(exec, throwing);
+#endif
+#if defined(KOKKOS_ENABLE_HPX)
+    static_assert(!hpx::kokkos::is_execution_space_synchronous<
+                      Kokkos::Experimental::HPX>::value,
+                  "Kokkos::Experimental::HPX should not be synchronous");
+#endif
   }
 
   Kokkos::finalize();
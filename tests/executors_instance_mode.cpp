@@ -12,7 +12,6 @@
 #include <hpx/execution.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
 
 #include <atomic>
 #include <cassert>
@@ -0,0 +1,151 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests selecting the strategy used to complete futures at runtime.
+
+#include "test.hpp"
+
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+#include <hpx/thread.hpp>
+
+#include <chrono>
+
+using hpx::kokkos::future_strategy;
+
+template <typename ExecutionSpace>
+void check_increment(ExecutionSpace const &inst,
+                     Kokkos::View<int *, ExecutionSpace> data, int expected) {
+  auto data_host = Kokkos::create_mirror_view(data);
+  Kokkos::deep_copy(inst, data_host, data);
+  inst.fence();
+  for (std::size_t i = 0; i < data.extent(0); ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == expected * int(i));
+  }
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+  auto increment = [&] {
+    return hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<execution_space>(inst, 0, n),
+        KOKKOS_LAMBDA(int i) { data(i) += i; });
+  };
+  int expected = 0;
+
+  // Every strategy completes futures on every execution space, falling back
+  // to the configured strategy where not supported
+  for (auto s : {future_strategy::unspecified, future_strategy::event,
+                 future_strategy::callback, future_strategy::host_task,
+                 future_strategy::fence, future_strategy::adaptive}) {
+    // Per call
+    Kokkos::parallel_for(Kokkos::RangePolicy<execution_space>(inst, 0, n),
+                         KOKKOS_LAMBDA(int i) { data(i) += i; });
+    hpx::kokkos::get_future(inst, s).get();
+    check_increment(inst, data, ++expected);
+
+    // Per scope
+    {
+      hpx::kokkos::future_strategy_scope scope(s);
+      increment().get();
+    }
+    check_increment(inst, data, ++expected);
+
+    // Per executor and policy
+    auto exec = hpx::kokkos::executor<execution_space>(inst)
+                    .with_future_strategy(s);
+    HPX_KOKKOS_DETAIL_TEST(exec.strategy() == s);
+    hpx::experimental::for_loop(
+        hpx::kokkos::kok(hpx::execution::task).on(exec), 0, n,
+        KOKKOS_LAMBDA(int i) { data(i) += i; })
+        .get();
+    check_increment(inst, data, ++expected);
+
+    // Globally
+    hpx::kokkos::set_future_strategy(s);
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_future_strategy() == s);
+    increment().get();
+    check_increment(inst, data, ++expected);
+    hpx::kokkos::set_future_strategy(future_strategy::unspecified);
+  }
+
+  // The adaptive strategy keeps working when all futures are considered long
+  hpx::kokkos::set_adaptive_future_threshold(std::chrono::nanoseconds(0));
+  {
+    hpx::kokkos::future_strategy_scope scope(future_strategy::adaptive);
+    for (int r = 0; r < 5; ++r) {
+      increment().get();
+      ++expected;
+    }
+  }
+  check_increment(inst, data, expected);
+  hpx::kokkos::set_adaptive_future_threshold(std::chrono::microseconds(100));
+}
+
+// Scopes apply to the HPX thread that created them, also after it was
+// suspended, and to the launches it defers, but not to other HPX threads
+void test_scope_per_hpx_thread() {
+  using hpx::kokkos::detail::resolve_future_strategy;
+  auto current = [] {
+    return resolve_future_strategy(future_strategy::unspecified);
+  };
+
+  hpx::kokkos::future_strategy_scope scope(future_strategy::fence);
+  HPX_KOKKOS_DETAIL_TEST(current() == future_strategy::fence);
+  auto other = hpx::async(current);
+  hpx::this_thread::yield();
+  HPX_KOKKOS_DETAIL_TEST(other.get() == future_strategy::unspecified);
+  HPX_KOKKOS_DETAIL_TEST(current() == future_strategy::fence);
+
+  hpx::promise<void> p;
+  future_strategy deferred = future_strategy::unspecified;
+  auto f = hpx::kokkos::detail::launch_after(
+      Kokkos::DefaultHostExecutionSpace{}, p.get_shared_future(), [&] {
+        deferred = current();
+        return hpx::shared_future<void>(hpx::make_ready_future());
+      });
+  hpx::async([&p] {
+    hpx::kokkos::future_strategy_scope other_scope(future_strategy::callback);
+    p.set_value();
+  }).get();
+  f.get();
+  HPX_KOKKOS_DETAIL_TEST(deferred == future_strategy::fence);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    for (auto s : {future_strategy::event, future_strategy::callback,
+                   future_strategy::host_task, future_strategy::fence,
+                   future_strategy::adaptive}) {
+      HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::detail::parse_future_strategy(
+                                 hpx::kokkos::to_string(s)) == s);
+    }
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::detail::parse_future_strategy("x") ==
+                           future_strategy::unspecified);
+
+    test_scope_per_hpx_thread();
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
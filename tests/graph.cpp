@@ -0,0 +1,118 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests recording launches in a graph and replaying them.
+
+#include "test.hpp"
+
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+template <typename ExecutionSpace> void test_replay(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+  Kokkos::View<int *, execution_space> data("data", n);
+  for (std::size_t i = 0; i < n; ++i) {
+    data_host(i) = 0;
+  }
+
+  hpx::kokkos::graph<execution_space> g(inst);
+  g.capture([&](execution_space const &space) {
+    hpx::kokkos::deep_copy_async(space, data, data_host);
+    hpx::kokkos::parallel_for_async(
+        "increment", Kokkos::RangePolicy<execution_space>(space, 0, n),
+        KOKKOS_LAMBDA(int i) { data(i) += i; });
+    hpx::kokkos::deep_copy_async(space, data_host, data);
+  });
+
+  // Nothing is executed while capturing
+  HPX_KOKKOS_DETAIL_TEST(g.size() == 3);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 0);
+  }
+
+  // Each replay increments the data once more
+  for (int r = 1; r <= 3; ++r) {
+    g.launch().get();
+    for (std::size_t i = 0; i < n; ++i) {
+      HPX_KOKKOS_DETAIL_TEST(data_host(i) == r * i);
+    }
+  }
+
+  // Replays can be launched after dependencies
+  hpx::promise<void> p;
+  auto f = g.launch(p.get_future());
+  HPX_KOKKOS_DETAIL_TEST(!f.is_ready());
+  p.set_value();
+  f.get();
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 4 * i);
+  }
+}
+
+template <typename ExecutionSpace> void test_for_each(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> data_host("data_host",
+                                                                   n);
+
+  hpx::kokkos::executor<execution_space> exec(inst);
+  hpx::kokkos::graph<execution_space> g(exec);
+  g.capture([&](execution_space const &space) {
+    hpx::for_each(hpx::kokkos::kok.on(exec), data.data(),
+                  data.data() + data.size(), KOKKOS_LAMBDA(int &x) { x += 2; });
+    hpx::kokkos::deep_copy_async(space, data_host, data);
+  });
+  HPX_KOKKOS_DETAIL_TEST(g.size() == 2);
+
+  g.launch().get();
+  g.launch().get();
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 4);
+  }
+
+  // Launches outside of capture are executed immediately
+  g.clear();
+  HPX_KOKKOS_DETAIL_TEST(g.size() == 0);
+  hpx::kokkos::deep_copy_async(inst, data, 0).get();
+  hpx::kokkos::deep_copy_async(inst, data_host, data).get();
+  HPX_KOKKOS_DETAIL_TEST(g.size() == 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 0);
+  }
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  test_replay(inst);
+  test_for_each(inst);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,124 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests running small ranges of HPX algorithms inline on the calling thread.
+
+#include "test.hpp"
+
+#include <hpx/algorithm.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <stdexcept>
+
+template <typename ExecutionSpace> void test(std::size_t threshold) {
+  hpx::kokkos::executor<ExecutionSpace> exec;
+  int const n = 1000;
+  int const m = 10;
+  Kokkos::View<int *, ExecutionSpace> data("data", n);
+
+  // A small range launched after a large one on the same instance runs after
+  // it, whether it runs inline or not
+  auto f = hpx::experimental::for_loop(
+      hpx::kokkos::kok(hpx::execution::task)
+          .on(exec)
+          .inline_threshold(threshold)
+          .label("inline large"),
+      0, n, KOKKOS_LAMBDA(int i) { data(i) = i; });
+  auto g = hpx::experimental::for_loop(
+      hpx::kokkos::kok(hpx::execution::task)
+          .on(exec)
+          .inline_threshold(threshold)
+          .label("inline small"),
+      0, m, KOKKOS_LAMBDA(int i) { data(i) *= 2; });
+  hpx::wait_all(f, g);
+
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data(i) == (i < m ? 2 * i : i));
+  }
+
+  hpx::for_each(
+      hpx::kokkos::kok.on(exec).inline_threshold(threshold).label(
+          "inline for_each"),
+      data.data(), data.data() + m, KOKKOS_LAMBDA(int &x) { x += 1; });
+  for (int i = 0; i < m; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data(i) == 2 * i + 1);
+  }
+
+  int const sum = hpx::reduce(
+      hpx::kokkos::kok.on(exec).inline_threshold(threshold).label(
+          "inline reduce"),
+      data.data(), data.data() + m, 3,
+      KOKKOS_LAMBDA(int x, int y) { return x + y; });
+  HPX_KOKKOS_DETAIL_TEST(sum == 3 + m * m);
+
+  Kokkos::View<int *, ExecutionSpace> result("result", m);
+  auto last = hpx::transform(
+      hpx::kokkos::kok.on(exec).inline_threshold(threshold).label(
+          "inline transform"),
+      data.data(), data.data() + m, result.data(),
+      KOKKOS_LAMBDA(int x) { return x - 1; });
+  HPX_KOKKOS_DETAIL_TEST(last == result.data() + m);
+  for (int i = 0; i < m; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(result(i) == 2 * i);
+  }
+
+  // A range run inline returns a ready future
+  if (threshold >= std::size_t(m)) {
+    auto h = hpx::experimental::for_loop(
+        hpx::kokkos::kok(hpx::execution::task)
+            .on(exec)
+            .inline_threshold(threshold)
+            .label("inline ready"),
+        0, m, KOKKOS_LAMBDA(int i) { data(i) = 0; });
+    HPX_KOKKOS_DETAIL_TEST(h.is_ready());
+
+    // Exceptions from a range run inline are returned in the future, as from
+    // a kernel
+    auto e = hpx::for_each(hpx::kokkos::kok(hpx::execution::task)
+                               .on(exec)
+                               .inline_threshold(threshold)
+                               .label("inline exception"),
+                           data.data(), data.data() + m,
+                           [](int &) { throw std::runtime_error("inline"); });
+    HPX_KOKKOS_DETAIL_TEST(e.is_ready() && e.has_exception());
+  }
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    // Nothing runs inline until the threshold is set or calibrated
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_inline_threshold() == 0);
+
+    std::size_t const calibrated = hpx::kokkos::calibrate_inline_threshold();
+    HPX_KOKKOS_DETAIL_TEST(calibrated <=
+                           hpx::kokkos::detail::inline_threshold_state::
+                               max_threshold);
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_inline_threshold() == calibrated);
+
+    hpx::kokkos::set_inline_threshold(5);
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_inline_threshold() == 5);
+
+    for (std::size_t const threshold :
+         {std::size_t(0), std::size_t(100),
+          hpx::kokkos::default_inline_threshold}) {
+      test<Kokkos::DefaultHostExecutionSpace>(threshold);
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
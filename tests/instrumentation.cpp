@@ -0,0 +1,104 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests instrumentation of launches and the performance counters exposing it.
+
+#include "test.hpp"
+
+#include <hpx/config.hpp>
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+#include <hpx/include/performance_counters.hpp>
+#endif
+#include <hpx/kokkos.hpp>
+#include <hpx/thread.hpp>
+
+#include <cstdint>
+
+// Performance counters are only available with the distributed runtime
+std::int64_t counter_value(char const *name) {
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+  return hpx::performance_counters::performance_counter(name)
+      .get_value<std::int64_t>(hpx::launch::sync);
+#else
+  (void)name;
+  return 0;
+#endif
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+  int const repetitions = 5;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+
+  auto const before = hpx::kokkos::get_kernel_statistics("instrumented");
+  auto const launched_before =
+      counter_value("/hpx-kokkos{locality#0/total}/kernels/launched");
+
+  for (int r = 0; r < repetitions; ++r) {
+    hpx::kokkos::parallel_for_async(
+        "instrumented", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+        KOKKOS_LAMBDA(int i) { data(i) = i; })
+        .get();
+  }
+
+  // Completions are recorded by a continuation that may still be running
+  // when get returns
+  auto after = hpx::kokkos::get_kernel_statistics("instrumented");
+  while (after.completed - before.completed < repetitions) {
+    hpx::this_thread::yield();
+    after = hpx::kokkos::get_kernel_statistics("instrumented");
+  }
+  HPX_KOKKOS_DETAIL_TEST(after.launched - before.launched == repetitions);
+  HPX_KOKKOS_DETAIL_TEST(after.completed - before.completed == repetitions);
+  HPX_KOKKOS_DETAIL_TEST(after.completion_time >= before.completion_time);
+#if defined(HPX_HAVE_DISTRIBUTED_RUNTIME)
+  HPX_KOKKOS_DETAIL_TEST(
+      counter_value("/hpx-kokkos{locality#0/total}/kernels/launched") -
+          launched_before ==
+      repetitions);
+  HPX_KOKKOS_DETAIL_TEST(
+      counter_value("/hpx-kokkos{locality#0/total}/kernels/inflight") == 0);
+#else
+  (void)launched_before;
+#endif
+
+  // Nothing is recorded while instrumentation is disabled
+  hpx::kokkos::enable_instrumentation(false);
+  hpx::kokkos::parallel_for_async(
+      "instrumented", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; })
+      .get();
+  HPX_KOKKOS_DETAIL_TEST(
+      hpx::kokkos::get_kernel_statistics("instrumented").launched ==
+      after.launched);
+  hpx::kokkos::enable_instrumentation();
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    hpx::kokkos::enable_instrumentation();
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -11,7 +11,6 @@
 #include <hpx/chrono.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
 
 #include <string>
 
@@ -109,9 +108,6 @@ int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
   {
-    hpx::kokkos::detail::polling_helper p;
-    (void)p;
-
     test(Kokkos::DefaultExecutionSpace{});
     if (!std::is_same<Kokkos::DefaultExecutionSpace,
                       Kokkos::DefaultHostExecutionSpace>::value) {
@@ -0,0 +1,118 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests runtime configuration and output of logging.
+
+#include "test.hpp"
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+#include <hpx/kokkos/detail/logging.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::mutex messages_mutex;
+std::vector<std::string> messages;
+
+std::vector<std::string> take_messages() {
+  hpx::kokkos::flush_log();
+  std::lock_guard<std::mutex> l(messages_mutex);
+  auto m = std::move(messages);
+  messages.clear();
+  return m;
+}
+
+std::size_t count(std::vector<std::string> const &m, std::string const &sub) {
+  std::size_t n = 0;
+  for (auto const &s : m) {
+    if (s.find(sub) != std::string::npos) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+void test_format() {
+  hpx::kokkos::set_log_level(hpx::kokkos::log_category::general,
+                             hpx::kokkos::log_level::debug);
+  HPX_KOKKOS_DETAIL_LOG("values %d, %zu, %x, %5.2f, %s, 100%%", -3,
+                        std::size_t(5), 255u, 1.5, std::string("label"));
+  auto const m = take_messages();
+  HPX_KOKKOS_DETAIL_TEST(m.size() == 1);
+  HPX_KOKKOS_DETAIL_TEST(
+      count(m, "[general] [debug] values -3, 5, ff,  1.50, label, 100%") == 1);
+
+  // Messages above the configured level are not recorded
+  hpx::kokkos::set_log_level(hpx::kokkos::log_category::general,
+                             hpx::kokkos::log_level::info);
+  HPX_KOKKOS_DETAIL_LOG("not recorded");
+  HPX_KOKKOS_DETAIL_TEST(take_messages().empty());
+  hpx::kokkos::set_log_level(hpx::kokkos::log_level::off);
+}
+
+template <typename ExecutionSpace> void test_categories(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 10;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+  hpx::kokkos::executor<execution_space> exec(inst);
+
+  hpx::kokkos::set_log_level(hpx::kokkos::log_category::launch,
+                             hpx::kokkos::log_level::debug);
+  hpx::kokkos::parallel_for_async(
+      Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; })
+      .get();
+  auto m = take_messages();
+  HPX_KOKKOS_DETAIL_TEST(
+      count(m, "[launch] [debug] calling parallel_for_async") == 1);
+  HPX_KOKKOS_DETAIL_TEST(count(m, "[future]") == 0);
+
+  // Logging from kernels only runs on the host, at the trace level
+  hpx::kokkos::set_log_level(hpx::kokkos::log_category::launch,
+                             hpx::kokkos::log_level::off);
+  hpx::kokkos::set_log_level(hpx::kokkos::log_category::kernel,
+                             hpx::kokkos::log_level::trace);
+  hpx::for_each(hpx::kokkos::kok.on(exec), data.data(),
+                data.data() + data.size(), KOKKOS_LAMBDA(int &x) { x += 1; });
+  m = take_messages();
+  HPX_KOKKOS_DETAIL_TEST(count(m, "[launch]") == 0);
+  if (Kokkos::SpaceAccessibility<execution_space,
+                                 Kokkos::HostSpace>::accessible) {
+    HPX_KOKKOS_DETAIL_TEST(count(m, "[kernel] [trace] for_each i = ") == n);
+  }
+  hpx::kokkos::set_log_level(hpx::kokkos::log_level::off);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    hpx::kokkos::set_log_sink([](std::string const &s) {
+      std::lock_guard<std::mutex> l(messages_mutex);
+      messages.push_back(s);
+    });
+
+    test_format();
+    test_categories(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test_categories(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
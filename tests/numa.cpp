@@ -0,0 +1,117 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests NUMA-aware instances, executors, and first-touch view allocation. The
+/// thread pools of the NUMA domains are created at startup.
+
+#include "test.hpp"
+
+#include <hpx/algorithm.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/resource_partitioner.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <cstddef>
+
+// Only HPX instances are bound to the pools of the domains
+template <typename ExecutionSpace>
+void test_domains(hpx::kokkos::numa_instance_helper<ExecutionSpace> const &) {}
+
+#if defined(KOKKOS_ENABLE_HPX)
+void test_domains(
+    hpx::kokkos::numa_instance_helper<Kokkos::Experimental::HPX> const
+        &helper) {
+  using execution_space = Kokkos::Experimental::HPX;
+  auto const pools = hpx::kokkos::detail::get_numa_thread_pools(
+      hpx::kokkos::default_numa_thread_pool_prefix);
+  HPX_KOKKOS_DETAIL_TEST(helper.num_domains() ==
+                         (pools.empty() ? 1 : pools.size()));
+
+  // Instances are bound to the pool of their domain, and the tasks of their
+  // kernels run only on workers of that pool
+  for (std::size_t d = 0; d < helper.num_domains(); ++d) {
+    auto const &inst = helper.get_execution_space(d);
+    auto const *binding = hpx::kokkos::detail::find_thread_pool_binding(inst);
+    auto *pool = pools.empty() ? &hpx::resource::get_thread_pool(0) : pools[d];
+    HPX_KOKKOS_DETAIL_TEST(binding != nullptr);
+    HPX_KOKKOS_DETAIL_TEST(binding->pool == pool);
+    HPX_KOKKOS_DETAIL_TEST(binding->concurrency ==
+                           pool->get_os_thread_count());
+
+    int const n = 1000;
+    Kokkos::View<std::size_t *, Kokkos::HostSpace> threads("threads", n);
+    hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<execution_space>(inst, 0, n),
+        [=](int i) { threads(i) = hpx::get_worker_thread_num(); })
+        .get();
+
+    std::size_t const first = pool->get_thread_offset();
+    std::size_t const last = first + pool->get_os_thread_count();
+    for (int i = 0; i < n; ++i) {
+      HPX_KOKKOS_DETAIL_TEST(threads(i) >= first && threads(i) < last);
+    }
+  }
+}
+#endif
+
+template <typename ExecutionSpace> void test() {
+  hpx::kokkos::numa_instance_helper<ExecutionSpace> helper;
+  HPX_KOKKOS_DETAIL_TEST(helper.num_domains() > 0);
+  test_domains(helper);
+
+  // Views are initialized by first touch, and the blocks of a loop over the
+  // same extent are launched on the instances of the domains
+  auto exec = helper.get_numa_executor();
+  HPX_KOKKOS_DETAIL_TEST(exec.size() == helper.num_domains());
+
+  int const n = 1000;
+  using view_type = Kokkos::View<int *, ExecutionSpace>;
+  auto data = hpx::kokkos::make_first_touch_view<view_type>(exec, "data", n);
+  auto data_host = Kokkos::create_mirror_view(data);
+  Kokkos::deep_copy(data_host, data);
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 0);
+  }
+
+  hpx::experimental::for_loop(
+      hpx::kokkos::kok(hpx::execution::task).on(exec), 0, n,
+      KOKKOS_LAMBDA(int i) { data(i) += i; })
+      .get();
+  hpx::experimental::for_loop(hpx::kokkos::kok.on(exec), 0, n,
+                              KOKKOS_LAMBDA(int i) { data(i) += i; });
+  exec.get_future().get();
+
+  Kokkos::deep_copy(data_host, data);
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == 2 * i);
+  }
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test<Kokkos::DefaultExecutionSpace>();
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test<Kokkos::DefaultHostExecutionSpace>();
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  hpx::init_params p;
+  p.rp_callback = [](hpx::resource::partitioner &rp,
+                     hpx::program_options::variables_map const &) {
+    hpx::kokkos::create_numa_thread_pools(rp);
+  };
+  return hpx::init(test_main, argc, argv, p);
+}
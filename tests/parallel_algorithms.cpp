@@ -11,7 +11,6 @@
 #include <hpx/algorithm.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
 #include <hpx/numeric.hpp>
 
 template <typename Executor> void test_for_each(Executor &&exec) {
@@ -425,6 +424,44 @@ void test_reduce_default() {
   HPX_KOKKOS_DETAIL_TEST(f_result.get() == (offset + (n * (n - 1)) / 2));
 }
 
+template <typename Executor> void test_transform(Executor &&exec) {
+  int const n = 43;
+
+  Kokkos::View<int *, Kokkos::DefaultHostExecutionSpace> transform_data_host(
+      "transform_data_host", n);
+  Kokkos::View<int *, typename std::decay<Executor>::type::execution_space>
+      transform_data("transform_data", n);
+  Kokkos::View<int *, typename std::decay<Executor>::type::execution_space>
+      transform_result("transform_result", n);
+  for (std::size_t i = 0; i < n; ++i) {
+    transform_data_host(i) = i;
+  }
+  Kokkos::deep_copy(transform_data, transform_data_host);
+
+  int *end = hpx::transform(
+      hpx::kokkos::kok.on(exec).label("transform sync"),
+      transform_data.data(), transform_data.data() + transform_data.size(),
+      transform_result.data(), KOKKOS_LAMBDA(int x) { return 2 * x; });
+  HPX_KOKKOS_DETAIL_TEST(end == transform_result.data() + n);
+
+  Kokkos::deep_copy(transform_data_host, transform_result);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(transform_data_host(i) == 2 * i);
+  }
+
+  auto f = hpx::transform(
+      hpx::kokkos::kok(hpx::execution::task).on(exec).label("transform task"),
+      transform_result.data(),
+      transform_result.data() + transform_result.size(), transform_data.data(),
+      KOKKOS_LAMBDA(int x) { return 3 * x; });
+  HPX_KOKKOS_DETAIL_TEST(f.get() == transform_data.data() + n);
+
+  Kokkos::deep_copy(transform_data_host, transform_data);
+  for (std::size_t i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(transform_data_host(i) == 3 * 2 * i);
+  }
+}
+
 template <typename Executor> void test(Executor &&exec) {
   static_assert(hpx::kokkos::is_kokkos_executor<Executor>::value,
                 "Executor is not a Kokkos executor");
@@ -440,6 +477,7 @@ template <typename Executor> void test(Executor &&exec) {
   test_for_each_mdrange(exec);
   test_for_loop(exec);
   test_reduce(exec);
+  test_transform(exec);
 }
 
 void test_default() {
@@ -457,14 +495,19 @@ int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
   {
-    hpx::kokkos::detail::polling_helper p;
-    (void)p;
-
     test(hpx::kokkos::default_executor{});
     if (!std::is_same<hpx::kokkos::default_executor,
                       hpx::kokkos::default_host_executor>::value) {
       test(hpx::kokkos::default_host_executor{});
     }
+    test(hpx::kokkos::numa_executor<Kokkos::DefaultExecutionSpace>{});
+    test(hpx::kokkos::partitioning_executor<Kokkos::DefaultExecutionSpace>{3});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(hpx::kokkos::numa_executor<Kokkos::DefaultHostExecutionSpace>{});
+      test(hpx::kokkos::partitioning_executor<
+           Kokkos::DefaultHostExecutionSpace>{3});
+    }
     test_default();
   }
 
@@ -0,0 +1,119 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests polling control, and adaptive polling using the fence strategy, which
+/// is available on all execution spaces.
+
+#include "test.hpp"
+
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+#include <hpx/thread.hpp>
+
+#include <chrono>
+#include <vector>
+
+void wait_until_inactive() {
+  while (hpx::kokkos::get_polling_statistics().active) {
+    hpx::this_thread::yield();
+  }
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+  int const num_futures = 10;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+
+  wait_until_inactive();
+  auto const before = hpx::kokkos::get_polling_statistics();
+
+  std::vector<hpx::shared_future<void>> futures;
+  {
+    hpx::kokkos::future_strategy_scope scope(
+        hpx::kokkos::future_strategy::fence);
+    for (int f = 0; f < num_futures; ++f) {
+      futures.push_back(hpx::kokkos::parallel_for_async(
+          Kokkos::RangePolicy<execution_space>(inst, 0, n),
+          KOKKOS_LAMBDA(int i) { data(i) += i; }));
+    }
+  }
+  hpx::wait_all(futures);
+
+  // The polling task stops once no futures are in flight
+  wait_until_inactive();
+  auto const after = hpx::kokkos::get_polling_statistics();
+  HPX_KOKKOS_DETAIL_TEST(after.in_flight == 0);
+  HPX_KOKKOS_DETAIL_TEST(after.starts > before.starts);
+  HPX_KOKKOS_DETAIL_TEST(after.completions - before.completions ==
+                         num_futures);
+  HPX_KOKKOS_DETAIL_TEST(after.fences - before.fences == num_futures);
+  HPX_KOKKOS_DETAIL_TEST(after.polls > before.polls);
+
+  auto data_host = Kokkos::create_mirror_view(data);
+  Kokkos::deep_copy(data_host, data);
+  for (int i = 0; i < n; ++i) {
+    HPX_KOKKOS_DETAIL_TEST(data_host(i) == num_futures * i);
+  }
+
+  // Nothing is polled while no futures are in flight
+  hpx::this_thread::sleep_for(std::chrono::milliseconds(10));
+  HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_polling_statistics().polls ==
+                         after.polls);
+}
+
+void test_scheduler_polling() {
+  // Polling of the default pool is enabled at startup, and stays enabled
+  // when scopes enabling it again end
+  HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::polling_enabled());
+  {
+    hpx::kokkos::polling_scope p;
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::polling_enabled());
+  }
+  HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::polling_enabled());
+
+  hpx::kokkos::disable_polling();
+  HPX_KOKKOS_DETAIL_TEST(!hpx::kokkos::polling_enabled());
+  hpx::kokkos::enable_polling();
+  HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::polling_enabled());
+
+  HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_pending_polling_events() == 0);
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test_scheduler_polling();
+
+    hpx::kokkos::polling_parameters p;
+    p.min_backoff = std::chrono::microseconds(10);
+    p.max_backoff = std::chrono::microseconds(100);
+    hpx::kokkos::set_polling_parameters(p);
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::get_polling_parameters().max_backoff ==
+                           p.max_backoff);
+
+    hpx::kokkos::enable_adaptive_polling();
+    HPX_KOKKOS_DETAIL_TEST(hpx::kokkos::adaptive_polling_enabled());
+
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,157 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests binding execution space instances to an HPX thread pool and a
+/// concurrency limit.
+
+#include "test.hpp"
+
+#include <hpx/execution.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+
+#include <cstddef>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+template <typename ExecutionSpace> void test() {
+  // Execution spaces other than HPX ignore the binding, but kernels on the
+  // returned instances and executors still work
+  int const n = 43;
+  for (std::string const pool : {"", "default"}) {
+    for (std::size_t concurrency : {0, 1, 3}) {
+      auto inst =
+          hpx::kokkos::make_independent_execution_space_instance<
+              ExecutionSpace>(pool, concurrency);
+      hpx::kokkos::executor<ExecutionSpace> exec(pool, concurrency);
+
+      Kokkos::View<int *, ExecutionSpace> data("data", n);
+      hpx::kokkos::parallel_for_async(
+          Kokkos::RangePolicy<ExecutionSpace>(inst, 0, n),
+          KOKKOS_LAMBDA(int i) { data(i) = i; })
+          .get();
+      hpx::experimental::for_loop(
+          hpx::kokkos::kok(hpx::execution::task).on(exec), 0, n,
+          KOKKOS_LAMBDA(int i) { data(i) += i; })
+          .get();
+
+      auto data_host = Kokkos::create_mirror_view(data);
+      Kokkos::deep_copy(data_host, data);
+      for (int i = 0; i < n; ++i) {
+        HPX_KOKKOS_DETAIL_TEST(data_host(i) == 2 * i);
+      }
+    }
+  }
+}
+
+#if defined(KOKKOS_ENABLE_HPX)
+template <> void test<Kokkos::Experimental::HPX>() {
+  using execution_space = Kokkos::Experimental::HPX;
+  int const n = 1000;
+  auto &default_pool = hpx::resource::get_thread_pool(0);
+
+  for (std::size_t concurrency : {1, 2}) {
+    hpx::kokkos::executor<execution_space> exec("", concurrency);
+    auto inst = exec.instance();
+
+    auto const *binding =
+        hpx::kokkos::detail::find_thread_pool_binding(inst);
+    HPX_KOKKOS_DETAIL_TEST(binding != nullptr);
+    HPX_KOKKOS_DETAIL_TEST(binding->pool == &default_pool);
+    HPX_KOKKOS_DETAIL_TEST(binding->concurrency == concurrency);
+
+    // Kernels run on the bound pool, in at most as many tasks as the
+    // concurrency limit. Every task runs on a single worker thread.
+    Kokkos::View<std::size_t *, Kokkos::HostSpace> threads("threads", n);
+    Kokkos::View<int *, Kokkos::HostSpace> on_pool("on_pool", n);
+    hpx::kokkos::parallel_for_async(
+        Kokkos::RangePolicy<execution_space>(inst, 0, n), [=](int i) {
+          threads(i) = hpx::get_worker_thread_num();
+          on_pool(i) = hpx::this_thread::get_pool() == &default_pool;
+        })
+        .get();
+
+    std::set<std::size_t> distinct_threads;
+    for (int i = 0; i < n; ++i) {
+      distinct_threads.insert(threads(i));
+      HPX_KOKKOS_DETAIL_TEST(on_pool(i) == 1);
+    }
+    HPX_KOKKOS_DETAIL_TEST(distinct_threads.size() <= concurrency);
+  }
+
+  // Launches from threads outside of the pool are submitted before they
+  // return, so that later waits on the instance include them
+  {
+    hpx::kokkos::executor<execution_space> exec("", 2);
+    auto inst = exec.instance();
+    auto other =
+        hpx::kokkos::detail::make_independent_execution_space_instance<
+            execution_space>();
+    Kokkos::View<int *, Kokkos::HostSpace> data("data", n);
+    hpx::shared_future<void> f;
+    hpx::shared_future<void> g;
+    std::thread t([&] {
+      hpx::kokkos::parallel_for_async(
+          Kokkos::RangePolicy<execution_space>(inst, 0, n),
+          [=](int i) { data(i) = i; });
+      g = hpx::kokkos::get_future(inst);
+      hpx::kokkos::parallel_for_async(
+          Kokkos::RangePolicy<execution_space>(inst, 0, n),
+          [=](int i) { data(i) += 1; });
+      f = hpx::kokkos::parallel_for_async(
+          hpx::kokkos::after(inst),
+          Kokkos::RangePolicy<execution_space>(other, 0, n),
+          [=](int i) { data(i) *= 2; });
+    });
+    t.join();
+    g.get();
+    f.get();
+    for (int i = 0; i < n; ++i) {
+      HPX_KOKKOS_DETAIL_TEST(data(i) == 2 * (i + 1));
+    }
+
+    // Bound instances can not be rebound
+    bool rebound = true;
+    try {
+      hpx::kokkos::detail::thread_pool_bindings::get().bind(
+          inst.impl_instance_id(),
+          *hpx::kokkos::detail::find_thread_pool_binding(inst));
+    } catch (std::runtime_error const &) {
+      rebound = false;
+    }
+    HPX_KOKKOS_DETAIL_TEST(!rebound);
+  }
+
+  // Unbound instances are not limited
+  auto inst = hpx::kokkos::detail::make_independent_execution_space_instance<
+      execution_space>();
+  HPX_KOKKOS_DETAIL_TEST(
+      hpx::kokkos::detail::find_thread_pool_binding(inst) == nullptr);
+}
+#endif
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test<Kokkos::DefaultExecutionSpace>();
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test<Kokkos::DefaultHostExecutionSpace>();
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -0,0 +1,122 @@
+//  Copyright (c) 2020 ETH Zurich
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file
+/// Tests tracing of launches.
+
+#include "test.hpp"
+
+#include <hpx/future.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/kokkos.hpp>
+#include <hpx/thread.hpp>
+
+#include <sstream>
+#include <string>
+
+std::size_t count(std::string const &s, std::string const &sub) {
+  std::size_t n = 0;
+  for (auto pos = s.find(sub); pos != std::string::npos;
+       pos = s.find(sub, pos + sub.size())) {
+    ++n;
+  }
+  return n;
+}
+
+template <typename ExecutionSpace> void test(ExecutionSpace &&inst) {
+  using execution_space = typename std::decay<ExecutionSpace>::type;
+  int const n = 43;
+
+  Kokkos::View<int *, execution_space> data("data", n);
+
+  hpx::kokkos::executor<execution_space> exec(inst);
+
+  hpx::kokkos::clear_trace();
+  hpx::kokkos::enable_tracing();
+  hpx::kokkos::parallel_for_async(
+      "traced \"kernel\"", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; })
+      .get();
+  hpx::for_each(hpx::kokkos::kok.on(exec).label("traced for_each"),
+                data.data(), data.data() + data.size(),
+                KOKKOS_LAMBDA(int &x) { x += 1; });
+  hpx::kokkos::enable_tracing(false);
+
+  // Ready events are recorded by a continuation that may still be running
+  // when get returns
+  std::string trace;
+  do {
+    hpx::this_thread::yield();
+    std::ostringstream os;
+    hpx::kokkos::write_trace(os);
+    trace = os.str();
+  } while (count(trace, "\"ph\":\"f\"") < 2);
+
+  HPX_KOKKOS_DETAIL_TEST(trace.find("{\"traceEvents\":[") == 0);
+  HPX_KOKKOS_DETAIL_TEST(trace.find("traced \\\"kernel\\\"") !=
+                         std::string::npos);
+  HPX_KOKKOS_DETAIL_TEST(trace.find("traced \\\"kernel\\\" ready") !=
+                         std::string::npos);
+  HPX_KOKKOS_DETAIL_TEST(trace.find("traced for_each") != std::string::npos);
+  HPX_KOKKOS_DETAIL_TEST(count(trace, "\"ph\":\"X\"") == 2);
+  HPX_KOKKOS_DETAIL_TEST(count(trace, "\"ph\":\"s\"") == 2);
+  HPX_KOKKOS_DETAIL_TEST(count(trace, "\"ph\":\"f\"") == 2);
+
+  // Nothing is recorded while tracing is disabled
+  hpx::kokkos::clear_trace();
+  hpx::kokkos::parallel_for_async(
+      "untraced", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+      KOKKOS_LAMBDA(int i) { data(i) = i; })
+      .get();
+  std::ostringstream os;
+  hpx::kokkos::write_trace(os);
+  HPX_KOKKOS_DETAIL_TEST(os.str() ==
+                         "{\"traceEvents\":[],\"otherData\":{"
+                         "\"dropped_events\":0}}\n");
+
+  // Only the most recent events are kept once the capacity is reached
+  hpx::kokkos::set_trace_capacity(2);
+  hpx::kokkos::enable_tracing();
+  for (int r = 0; r < 3; ++r) {
+    hpx::kokkos::parallel_for_async(
+        "bounded", Kokkos::RangePolicy<execution_space>(inst, 0, n),
+        KOKKOS_LAMBDA(int i) { data(i) = i; })
+        .get();
+  }
+  hpx::kokkos::enable_tracing(false);
+  // Ready events may still be recorded by continuations
+  while (hpx::kokkos::get_trace_dropped_events() < 4) {
+    hpx::this_thread::yield();
+  }
+  std::ostringstream bounded;
+  hpx::kokkos::write_trace(bounded);
+  HPX_KOKKOS_DETAIL_TEST(count(bounded.str(), "\"ph\":\"s\"") +
+                             count(bounded.str(), "\"ph\":\"f\"") ==
+                         2);
+  hpx::kokkos::set_trace_capacity(
+      hpx::kokkos::detail::tracer::default_capacity);
+  hpx::kokkos::clear_trace();
+}
+
+int test_main(int argc, char *argv[]) {
+  Kokkos::initialize(argc, argv);
+
+  {
+    test(Kokkos::DefaultExecutionSpace{});
+    if (!std::is_same<Kokkos::DefaultExecutionSpace,
+                      Kokkos::DefaultHostExecutionSpace>::value) {
+      test(Kokkos::DefaultHostExecutionSpace{});
+    }
+  }
+
+  Kokkos::finalize();
+  hpx::finalize();
+
+  return hpx::kokkos::detail::report_errors();
+}
+
+int main(int argc, char *argv[]) {
+  return hpx::init(test_main, argc, argv);
+}
@@ -11,7 +11,6 @@
 #include <hpx/algorithm.hpp>
 #include <hpx/hpx_init.hpp>
 #include <hpx/kokkos.hpp>
-#include <hpx/kokkos/detail/polling_helper.hpp>
 
 template <typename Executor> void test_for_each(Executor &&exec) {
   int const n = 43;
@@ -66,9 +65,6 @@ int test_main(int argc, char *argv[]) {
   Kokkos::initialize(argc, argv);
 
   {
-    hpx::kokkos::detail::polling_helper p;
-    (void)p;
-
     test(hpx::kokkos::default_executor{});
     if (!std::is_same<hpx::kokkos::default_executor,
                       hpx::kokkos::default_host_executor>::value) {